@@ -1,34 +1,126 @@
+#define _POSIX_C_SOURCE 200809L // fdopen, dup e sockets Unix do modo servidor
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdint.h> // Para int32_t e uint64_t (campo de distâncias e bitmap)
+#include <limits.h> // Para INT_MAX (limite de layout_fits)
+#include <time.h>   // Para clock() na medição dos geradores
 
-// --- Definies Globais e Estruturas ---
+// --- Definições Globais e Estruturas ---
 
-#define MAX_ROWS 10 // Tamanho mximo de linhas do labirinto
-#define MAX_COLS 10 // Tamanho mximo de colunas do labirinto
-#define MAX_NODES (MAX_ROWS * MAX_COLS) // Nmero mximo de ns no grafo
+#define MAX_ROWS 10 // Tamanho máximo de linhas do labirinto
+#define MAX_COLS 10 // Tamanho máximo de colunas do labirinto
+#define MAX_NODES (MAX_ROWS * MAX_COLS) // Número máximo de nós no grafo
 
-// Estrutura para representar uma clula (posio) no labirinto
+// Estrutura para representar uma célula (posição) no labirinto
 typedef struct {
     int row;
     int col;
 } Cell;
 
-// Estrutura para um n na lista de adjacncia
+// Estrutura para um nó na lista de adjacência
 typedef struct AdjListNode {
-    int dest; // ndice do n de destino
+    int dest; // Índice do nó de destino
     struct AdjListNode* next;
 } AdjListNode;
 
-// Estrutura para o Grafo (Lista de Adjacncia)
+// Estrutura para o Grafo (Lista de Adjacência)
 typedef struct Graph {
     int num_nodes;
-    AdjListNode** adj_lists; // Array de ponteiros para listas de adjacncia
+    AdjListNode** adj_lists; // Array de ponteiros para listas de adjacência
 } Graph;
 
-// Estrutura para um n da Fila (usado no BFS)
+// Campo de distâncias completo de uma BFS: distância e pai de cada célula
+typedef struct DistanceField {
+    int num_rows;
+    int num_cols;
+    int start_node; // Origem da busca
+    int* dist;      // Passos desde a origem (-1 se inalcançável ou parede)
+    int* parent;    // Predecessor no caminho mais curto (-1 na origem e fora do alcance)
+} DistanceField;
+
+// Estado do gerador pseudoaleatório (xorshift64*), reprodutível a partir da semente
+typedef struct Rng {
+    uint64_t state;
+} Rng;
+
+// Grafo ponderado de junções: corredores contraídos em arestas (listas contíguas, CSR)
+typedef struct JunctionGraph {
+    int num_cells;      // Células restantes após o preenchimento de becos
+    int num_junctions;
+    int num_edges;      // Arestas dirigidas (cada corredor aparece nos dois sentidos)
+    bool* removed;      // Células removidas como becos
+    int* junction_of;   // Junção de cada célula, ou -1 se não for junção
+    int* junction_cell; // Célula de cada junção
+    int* edge_offset;   // Arestas da junção j: edge_offset[j] .. edge_offset[j + 1] - 1
+    int* edge_target;   // Junção na outra ponta do corredor
+    int* edge_weight;   // Passos do corredor
+    int* edge_first;    // Primeira célula do corredor após a junção de origem
+} JunctionGraph;
+
+// Labirinto compacto: 1 bit por célula (1 = parede), linhas em palavras de 64 bits
+typedef struct MazeBitmap {
+    int num_rows;
+    int num_cols;
+    int words_per_row; // Palavras de 64 bits por linha
+    uint64_t* bits;    // num_rows * words_per_row palavras
+} MazeBitmap;
+
+// Labirinto compacto completo: paredes no bitmap, partida e saídas como coordenadas
+typedef struct PackedMaze {
+    MazeBitmap* walls;
+    Cell start;         // Partida 'S' (row = -1 se ausente)
+    Cell end;           // Chegada padrão: a última saída 'E' lida
+    Cell* exits;        // Todas as saídas 'E'
+    int num_exits;
+    int exits_capacity;
+    unsigned char* cost; // Custo de entrar em cada célula (dígitos '1'-'9'), NULL se todas custam 1
+} PackedMaze;
+
+// Regiões conexas do labirinto: mesmo rótulo = existe caminho entre as células
+typedef struct MazeComponents {
+    int num_rows;
+    int num_cols;
+    int num_components;
+    int* label; // Rótulo por célula (disposição de map_coord_to_index), -1 em paredes
+} MazeComponents;
+
+// Grafo abstrato do HPA*: transições nas bordas dos clusters e custos entre elas (CSR)
+typedef struct HpaGraph {
+    int num_rows;
+    int num_cols;
+    int cluster_size;     // Lado de cada cluster, em células
+    int clusters_per_row;
+    int min_cost;         // Menor custo do terreno (fator da heurística)
+    uint64_t fingerprint; // Impressão digital do labirinto de origem
+    int num_nodes;
+    int num_edges;
+    int* node_cell;       // Célula de cada transição, linha a linha (r * num_cols + c)
+    int* edge_offset;     // Arestas do nó n: edge_offset[n] .. edge_offset[n + 1] - 1
+    int* edge_target;
+    int* edge_cost;
+} HpaGraph;
+
+// Vizinhanças de movimento na grade
+typedef enum {
+    NEIGHBORHOOD_4,  // Cima, baixo, esquerda e direita
+    NEIGHBORHOOD_8,  // Mais as diagonais, sem cortar quinas (custos octis 10/14)
+    NEIGHBORHOOD_HEX // Hexágonos em linhas deslocadas ("odd-r")
+} Neighborhood;
+
+// Algoritmos de geração de labirintos
+typedef enum {
+    GEN_BACKTRACKER, // Backtracker recursivo (pilha explícita)
+    GEN_KRUSKAL,     // Kruskal aleatório com union-find
+    GEN_WILSON,      // Wilson (passeios com apagamento de laços)
+    GEN_RANDOM_FILL  // Preenchimento aleatório com densidade de paredes
+} MazeGenerator;
+
+// Estrutura para um nó da Fila (usado no BFS)
 typedef struct QueueNode {
-    int data; // ndice do n
+    int data; // Índice do nó
     struct QueueNode* next;
 } QueueNode;
 
@@ -37,25 +129,144 @@ typedef struct Queue {
     QueueNode *front, *rear;
 } Queue;
 
-// --- Funes Auxiliares de Converso ---
+// --- Funções Auxiliares de Conversão ---
+
+// Disposição das células nos arrays indexados por nó (visited, parent, dist...),
+// escolhida na compilação:
+//   (padrão)       linha a linha: r * num_cols + c
+//   -DLAYOUT_MORTON ordem Z (Morton) dentro de blocos de MORTON_TILE_SIZE, blocos linha a linha
+//   -DLAYOUT_TILED  blocos de TILE_SIZE x TILE_SIZE células contíguas
+// Nas duas últimas, vizinhos verticais tendem a cair na mesma linha de cache.
+// Os índices podem ter lacunas: arrays por nó devem ter layout_num_cells() posições.
+#define TILE_SHIFT 3
+#define TILE_SIZE (1 << TILE_SHIFT) // Lado do bloco (8 x 8 = 64 células)
+
+#if defined(LAYOUT_MORTON)
+#define LAYOUT_NAME "Morton (ordem Z em blocos 16x16)"
+
+// A ordem Z em toda a grade faria o espaço de índices crescer com o quadrado do
+// maior lado; em blocos fixos, as lacunas se limitam ao arredondamento das bordas
+#define MORTON_TILE_SHIFT 4
+#define MORTON_TILE_SIZE (1 << MORTON_TILE_SHIFT) // 16 x 16 = 256 células
+
+// Espalha os 16 bits baixos de x nas posições pares
+static inline uint32_t morton_spread(uint32_t x) {
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+// Recolhe os bits das posições pares de x
+static inline uint32_t morton_compact(uint32_t x) {
+    x &= 0x55555555;
+    x = (x | (x >> 1)) & 0x33333333;
+    x = (x | (x >> 2)) & 0x0F0F0F0F;
+    x = (x | (x >> 4)) & 0x00FF00FF;
+    x = (x | (x >> 8)) & 0x0000FFFF;
+    return x;
+}
+
+// Converte coordenadas (linha, coluna) para um índice único do nó
+int map_coord_to_index(int r, int c, int num_cols) {
+    int tiles_per_row = (num_cols + MORTON_TILE_SIZE - 1) >> MORTON_TILE_SHIFT;
+    int tile = (r >> MORTON_TILE_SHIFT) * tiles_per_row + (c >> MORTON_TILE_SHIFT);
+    uint32_t local = (morton_spread((uint32_t)(r & (MORTON_TILE_SIZE - 1))) << 1) |
+                     morton_spread((uint32_t)(c & (MORTON_TILE_SIZE - 1)));
+    return (tile << (2 * MORTON_TILE_SHIFT)) | (int)local;
+}
+
+// Converte um índice de nó para coordenadas (linha, coluna)
+void map_index_to_coord(int index, int num_cols, Cell* cell) {
+    int tiles_per_row = (num_cols + MORTON_TILE_SIZE - 1) >> MORTON_TILE_SHIFT;
+    int tile = index >> (2 * MORTON_TILE_SHIFT);
+    uint32_t local = (uint32_t)index & ((1u << (2 * MORTON_TILE_SHIFT)) - 1);
+    cell->row = ((tile / tiles_per_row) << MORTON_TILE_SHIFT) | (int)morton_compact(local >> 1);
+    cell->col = ((tile % tiles_per_row) << MORTON_TILE_SHIFT) | (int)morton_compact(local);
+}
+
+// Tamanho dos arrays por nó: as dimensões são arredondadas para blocos inteiros
+int layout_num_cells(int num_rows, int num_cols) {
+    int tile_rows = (num_rows + MORTON_TILE_SIZE - 1) >> MORTON_TILE_SHIFT;
+    int tile_cols = (num_cols + MORTON_TILE_SIZE - 1) >> MORTON_TILE_SHIFT;
+    return (tile_rows * tile_cols) << (2 * MORTON_TILE_SHIFT);
+}
+
+#elif defined(LAYOUT_TILED)
+#define LAYOUT_NAME "blocos 8x8"
+
+// Converte coordenadas (linha, coluna) para um índice único do nó
+int map_coord_to_index(int r, int c, int num_cols) {
+    int tiles_per_row = (num_cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    int tile = (r >> TILE_SHIFT) * tiles_per_row + (c >> TILE_SHIFT);
+    return (tile << (2 * TILE_SHIFT)) | ((r & (TILE_SIZE - 1)) << TILE_SHIFT) | (c & (TILE_SIZE - 1));
+}
+
+// Converte um índice de nó para coordenadas (linha, coluna)
+void map_index_to_coord(int index, int num_cols, Cell* cell) {
+    int tiles_per_row = (num_cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    int tile = index >> (2 * TILE_SHIFT);
+    cell->row = ((tile / tiles_per_row) << TILE_SHIFT) | ((index >> TILE_SHIFT) & (TILE_SIZE - 1));
+    cell->col = ((tile % tiles_per_row) << TILE_SHIFT) | (index & (TILE_SIZE - 1));
+}
+
+// Tamanho dos arrays por nó: as dimensões são arredondadas para blocos inteiros
+int layout_num_cells(int num_rows, int num_cols) {
+    int tile_rows = (num_rows + TILE_SIZE - 1) >> TILE_SHIFT;
+    int tile_cols = (num_cols + TILE_SIZE - 1) >> TILE_SHIFT;
+    return (tile_rows * tile_cols) << (2 * TILE_SHIFT);
+}
+
+#else
+#define LAYOUT_NAME "linha a linha"
 
-// Converte coordenadas (linha, coluna) para um ndice nico do n
+// Converte coordenadas (linha, coluna) para um índice único do nó
 int map_coord_to_index(int r, int c, int num_cols) {
     return r * num_cols + c;
 }
 
-// Converte um ndice de n para coordenadas (linha, coluna)
+// Converte um índice de nó para coordenadas (linha, coluna)
 void map_index_to_coord(int index, int num_cols, Cell* cell) {
     cell->row = index / num_cols;
     cell->col = index % num_cols;
 }
 
-// Verifica se uma clula est dentro dos limites do labirinto
+// Tamanho dos arrays por nó
+int layout_num_cells(int num_rows, int num_cols) {
+    return num_rows * num_cols;
+}
+#endif
+
+/**
+ * @brief Verifica se a grade cabe nos índices int de map_coord_to_index.
+ *
+ * O tamanho é calculado em 64 bits, com o arredondamento para blocos da
+ * disposição compilada; grades maiores que INT_MAX posições devem ser recusadas
+ * antes de qualquer alocação por nó.
+ *
+ * @return true se layout_num_cells(num_rows, num_cols) não transborda.
+ */
+bool layout_fits(int num_rows, int num_cols) {
+#if defined(LAYOUT_MORTON)
+    const int64_t side = MORTON_TILE_SIZE;
+#elif defined(LAYOUT_TILED)
+    const int64_t side = TILE_SIZE;
+#else
+    const int64_t side = 1;
+#endif
+    int64_t rows = ((int64_t)num_rows + side - 1) / side * side;
+    int64_t cols = ((int64_t)num_cols + side - 1) / side * side;
+    return rows * cols <= INT_MAX;
+}
+
+// Verifica se uma célula está dentro dos limites do labirinto
 bool is_valid(int r, int c, int num_rows, int num_cols) {
     return (r >= 0 && r < num_rows && c >= 0 && c < num_cols);
 }
 
-// --- Funes da Fila (para BFS) ---
+// --- Funções da Fila (para BFS) ---
 
 // Cria uma nova fila vazia
 Queue* create_queue() {
@@ -68,7 +279,7 @@ Queue* create_queue() {
     return q;
 }
 
-// Adiciona um elemento  fila
+// Adiciona um elemento à fila
 void enqueue(Queue* q, int data) {
     QueueNode* new_node = (QueueNode*)malloc(sizeof(QueueNode));
     if (!new_node) {
@@ -100,22 +311,22 @@ int dequeue(Queue* q) {
     return data;
 }
 
-// Verifica se a fila est vazia
+// Verifica se a fila está vazia
 bool is_empty_queue(Queue* q) {
     return q->front == NULL;
 }
 
-// Libera a memria da fila
+// Libera a memória da fila
 void free_queue(Queue* q) {
     while (!is_empty_queue(q)) {
-        dequeue(q); // Apenas chama para liberar os ns
+        dequeue(q); // Apenas chama para liberar os nós
     }
     free(q);
 }
 
-// --- Funes do Grafo ---
+// --- Funções do Grafo ---
 
-// Cria um novo n da lista de adjacncia
+// Cria um novo nó da lista de adjacência
 AdjListNode* create_adj_list_node(int dest) {
     AdjListNode* new_node = (AdjListNode*)malloc(sizeof(AdjListNode));
     if (!new_node) {
@@ -127,7 +338,7 @@ AdjListNode* create_adj_list_node(int dest) {
     return new_node;
 }
 
-// Cria um grafo com 'num_nodes' ns
+// Cria um grafo com 'num_nodes' nós
 Graph* create_graph(int num_nodes) {
     Graph* graph = (Graph*)malloc(sizeof(Graph));
     if (!graph) {
@@ -137,7 +348,7 @@ Graph* create_graph(int num_nodes) {
     graph->num_nodes = num_nodes;
     graph->adj_lists = (AdjListNode**)malloc(num_nodes * sizeof(AdjListNode*));
     if (!graph->adj_lists) {
-        perror("Erro ao alocar lista de adjacncia");
+        perror("Erro ao alocar lista de adjacência");
         free(graph);
         exit(EXIT_FAILURE);
     }
@@ -149,18 +360,18 @@ Graph* create_graph(int num_nodes) {
 
 // Adiciona uma aresta ao grafo (de src para dest)
 void add_edge(Graph* graph, int src, int dest) {
-    // Adiciona dest  lista de src
+    // Adiciona dest à lista de src
     AdjListNode* new_node = create_adj_list_node(dest);
     new_node->next = graph->adj_lists[src];
     graph->adj_lists[src] = new_node;
 
-    // Para um labirinto, as arestas so bidirecionais
+    // Para um labirinto, as arestas são bidirecionais
     new_node = create_adj_list_node(src);
     new_node->next = graph->adj_lists[dest];
     graph->adj_lists[dest] = new_node;
 }
 
-// Libera a memria do grafo
+// Libera a memória do grafo
 void free_graph(Graph* graph) {
     if (!graph) return;
     for (int i = 0; i < graph->num_nodes; i++) {
@@ -175,46 +386,219 @@ void free_graph(Graph* graph) {
     free(graph);
 }
 
-// --- Funes de Navegao (BFS e DFS) ---
+// --- Emissão de Caminhos ---
 
-// Imprime o caminho encontrado do incio ao fim
-void print_path(int parent[], int start_node, int end_node, int num_cols) {
-    if (end_node == -1) {
-        printf("Nenhum caminho encontrado.\n");
-        return;
+#define OUTPUT_BUFFER_SIZE 65536 // Bytes acumulados antes de cada fwrite
+
+// Buffer de saída: o texto é montado em memória e gravado em blocos
+typedef struct OutputBuffer {
+    FILE* file;
+    size_t length;
+    char data[OUTPUT_BUFFER_SIZE];
+} OutputBuffer;
+
+// Grava o conteúdo acumulado no arquivo
+void output_flush(OutputBuffer* out) {
+    if (out->length > 0) {
+        fwrite(out->data, 1, out->length, out->file);
+        out->length = 0;
     }
+}
 
-    // Constri o caminho de trs para frente
-    int path[MAX_NODES];
-    int path_len = 0;
-    int current = end_node;
+// Acrescenta 'length' bytes ao buffer
+void output_append(OutputBuffer* out, const char* text, size_t length) {
+    if (out->length + length > OUTPUT_BUFFER_SIZE) {
+        output_flush(out);
+    }
+    memcpy(&out->data[out->length], text, length);
+    out->length += length;
+}
 
-    while (current != -1 && current != start_node) {
-        path[path_len++] = current;
-        current = parent[current];
+// Acrescenta um inteiro não negativo em decimal, sem passar por printf
+void output_uint(OutputBuffer* out, unsigned int value) {
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0);
+    if (out->length + n > OUTPUT_BUFFER_SIZE) {
+        output_flush(out);
+    }
+    while (n > 0) {
+        out->data[out->length++] = digits[--n];
     }
-    path[path_len++] = start_node; // Adiciona o n inicial
+}
 
-    printf("Caminho encontrado:\n");
+/**
+ * @brief Escreve o caminho de start_node até end_node, em ordem direta, no buffer do chamador.
+ *
+ * A cadeia de pais é percorrida duas vezes: a primeira mede o caminho e a segunda
+ * preenche o buffer de trás para frente, dispensando cópia e inversão. Como em
+ * snprintf, nada é escrito se o buffer for pequeno; o retorno informa o tamanho
+ * necessário.
+ *
+ * @param parent Array de predecessores da busca.
+ * @param start_node O índice do nó de partida.
+ * @param end_node O índice do nó de chegada.
+ * @param path Buffer de saída (pode ser NULL se capacity for 0).
+ * @param capacity Número de posições disponíveis em path.
+ * @return O número de nós do caminho, ou 0 se end_node não leva a start_node.
+ */
+int emit_path(const int parent[], int start_node, int end_node, int path[], int capacity) {
+    if (end_node == -1) {
+        return 0;
+    }
+    int path_len = 1;
+    int current = end_node;
+    while (current != start_node) {
+        current = parent[current];
+        if (current == -1) {
+            return 0; // A cadeia de pais não chega à origem
+        }
+        path_len++;
+    }
+    if (path_len > capacity) {
+        return path_len;
+    }
+    current = end_node;
     for (int i = path_len - 1; i >= 0; i--) {
+        path[i] = current;
+        current = parent[current];
+    }
+    return path_len;
+}
+
+// Nome do passo from -> to (até duas letras). Nos hexágonos "odd-r" a diagonal
+// esquerda ou direita depende da paridade da linha de origem, não só da diferença
+// de colunas: de uma linha par, (-1, 0) é UR; de uma ímpar, é UL.
+static void step_direction(const int path[], int i, int num_cols, Neighborhood neighborhood, char direction[3]) {
+    Cell from, to;
+    map_index_to_coord(path[i - 1], num_cols, &from);
+    map_index_to_coord(path[i], num_cols, &to);
+    int dr = to.row - from.row;
+    int dc = to.col - from.col;
+    if (neighborhood == NEIGHBORHOOD_HEX && dr != 0) {
+        dc = dc - (from.row & 1) < 0 ? -1 : 1;
+    }
+    direction[0] = direction[1] = direction[2] = '\0';
+    if (dr != 0) direction[0] = dr < 0 ? 'U' : 'D';
+    if (dc != 0) direction[dr != 0] = dc < 0 ? 'L' : 'R';
+}
+
+/**
+ * @brief Codifica o caminho por direções com contagem de repetições ("R5 D3").
+ *
+ * Passos consecutivos na mesma direção viram um único par letra + contagem
+ * (U: cima, D: baixo, L: esquerda, R: direita; diagonais combinam duas letras,
+ * como "UR2"). Em NEIGHBORHOOD_HEX, UL/UR/DL/DR nomeiam os vizinhos hexagonais
+ * de cima e de baixo, e L/R os da mesma linha.
+ *
+ * @param path Os nós do caminho, em ordem.
+ * @param path_len O número de nós.
+ * @param num_cols Número de colunas do labirinto.
+ * @param neighborhood A vizinhança em que o caminho foi encontrado.
+ * @param buffer Saída terminada em '\0' (pode ser NULL se size for 0).
+ * @param size Tamanho de buffer em bytes.
+ * @return O número de caracteres da codificação completa (sem o '\0'), como snprintf.
+ */
+size_t encode_path_rle(const int path[], int path_len, int num_cols, Neighborhood neighborhood, char* buffer,
+                       size_t size) {
+    size_t length = 0;
+    int i = 1;
+    while (i < path_len) {
+        char direction[3];
+        step_direction(path, i, num_cols, neighborhood, direction);
+
+        // Estende a corrida enquanto o passo se repetir
+        int run = 1;
+        while (i + run < path_len) {
+            char next[3];
+            step_direction(path, i + run, num_cols, neighborhood, next);
+            if (strcmp(next, direction) != 0) {
+                break;
+            }
+            run++;
+        }
+        i += run;
+
+        char token[16];
+        int token_len = snprintf(token, sizeof(token), "%s%s%d", length > 0 ? " " : "", direction, run);
+        if (length + token_len < size) {
+            memcpy(&buffer[length], token, token_len);
+        }
+        length += token_len;
+    }
+    if (size > 0) {
+        buffer[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+}
+
+// Grava o caminho como "(r, c) -> (r, c) ..." usando escrita em blocos
+void write_path_coords(FILE* file, const int path[], int path_len, int num_cols) {
+    OutputBuffer* out = (OutputBuffer*)malloc(sizeof(OutputBuffer));
+    if (!out) {
+        perror("Erro ao alocar buffer de saída");
+        exit(EXIT_FAILURE);
+    }
+    out->file = file;
+    out->length = 0;
+    for (int i = 0; i < path_len; i++) {
         Cell cell;
         map_index_to_coord(path[i], num_cols, &cell);
-        printf("(%d, %d)", cell.row, cell.col);
-        if (i > 0) {
-            printf(" -> ");
-        }
+        output_append(out, "(", 1);
+        output_uint(out, (unsigned int)cell.row);
+        output_append(out, ", ", 2);
+        output_uint(out, (unsigned int)cell.col);
+        output_append(out, i + 1 < path_len ? ") -> " : ")\n", i + 1 < path_len ? 5 : 2);
+    }
+    output_flush(out);
+    free(out);
+}
+
+// --- Funções de Navegação (BFS e DFS) ---
+
+// Imprime o caminho encontrado do início ao fim (direções nomeadas conforme a vizinhança)
+void print_path(int parent[], int start_node, int end_node, int num_cols, Neighborhood neighborhood) {
+    int path_len = emit_path(parent, start_node, end_node, NULL, 0);
+    if (path_len == 0) {
+        printf("Nenhum caminho encontrado.\n");
+        return;
+    }
+
+    int* path = (int*)calloc(path_len, sizeof(int));
+    if (!path) {
+        perror("Erro ao alocar caminho");
+        exit(EXIT_FAILURE);
+    }
+    emit_path(parent, start_node, end_node, path, path_len);
+
+    size_t rle_len = encode_path_rle(path, path_len, num_cols, neighborhood, NULL, 0);
+    char* rle = (char*)malloc(rle_len + 1);
+    if (!rle) {
+        perror("Erro ao alocar caminho codificado");
+        exit(EXIT_FAILURE);
     }
-    printf("\n");
+    encode_path_rle(path, path_len, num_cols, neighborhood, rle, rle_len + 1);
+
+    printf("Caminho encontrado:\n");
+    fflush(stdout); // Mantém a ordem com a escrita em blocos abaixo
+    write_path_coords(stdout, path, path_len, num_cols);
+    printf("Direções: %s\n", path_len > 1 ? rle : "(nenhum movimento)");
+
+    free(rle);
+    free(path);
 }
 
 /**
  * @brief Realiza uma Busca em Largura (BFS) para encontrar o caminho mais curto.
  *
  * @param graph O grafo que representa o labirinto.
- * @param start_node O ndice do n de partida.
- * @param end_node O ndice do n de chegada.
- * @param num_rows Nmero de linhas do labirinto.
- * @param num_cols Nmero de colunas do labirinto.
+ * @param start_node O índice do nó de partida.
+ * @param end_node O índice do nó de chegada.
+ * @param num_rows Número de linhas do labirinto.
+ * @param num_cols Número de colunas do labirinto.
  */
 void bfs(Graph* graph, int start_node, int end_node, int num_rows, int num_cols) {
     printf("\n--- Iniciando Busca em Largura (BFS) ---\n");
@@ -255,7 +639,7 @@ void bfs(Graph* graph, int start_node, int end_node, int num_rows, int num_cols)
 
     if (path_found_end_node != -1) {
         printf("Caminho encontrado por BFS (mais curto):\n");
-        print_path(parent, start_node, path_found_end_node, num_cols);
+        print_path(parent, start_node, path_found_end_node, num_cols, NEIGHBORHOOD_4);
     } else {
         printf("Nenhum caminho encontrado por BFS.\n");
     }
@@ -263,20 +647,20 @@ void bfs(Graph* graph, int start_node, int end_node, int num_rows, int num_cols)
 }
 
 /**
- * @brief Funo recursiva para Busca em Profundidade (DFS).
+ * @brief Função recursiva para Busca em Profundidade (DFS).
  *
  * @param graph O grafo.
- * @param current_node O n atual sendo visitado.
- * @param end_node O n de chegada.
- * @param visited Array para marcar ns visitados.
+ * @param current_node O nó atual sendo visitado.
+ * @param end_node O nó de chegada.
+ * @param visited Array para marcar nós visitados.
  * @param parent Array para reconstruir o caminho.
- * @param num_cols Nmero de colunas do labirinto (para print_path).
- * @return true se o n de chegada foi encontrado a partir do current_node, false caso contrrio.
+ * @param num_cols Número de colunas do labirinto (para print_path).
+ * @return true se o nó de chegada foi encontrado a partir do current_node, false caso contrário.
  */
 bool dfs_recursive(Graph* graph, int current_node, int end_node, bool visited[], int parent[], int num_cols) {
     visited[current_node] = true;
 
-    // Se encontramos o n de chegada, retornamos true
+    // Se encontramos o nó de chegada, retornamos true
     if (current_node == end_node) {
         return true;
     }
@@ -292,17 +676,17 @@ bool dfs_recursive(Graph* graph, int current_node, int end_node, bool visited[],
         }
         temp = temp->next;
     }
-    return false; // Nenhum caminho encontrado a partir deste n
+    return false; // Nenhum caminho encontrado a partir deste nó
 }
 
 /**
  * @brief Inicia a Busca em Profundidade (DFS).
  *
  * @param graph O grafo que representa o labirinto.
- * @param start_node O ndice do n de partida.
- * @param end_node O ndice do n de chegada.
- * @param num_rows Nmero de linhas do labirinto.
- * @param num_cols Nmero de colunas do labirinto.
+ * @param start_node O índice do nó de partida.
+ * @param end_node O índice do nó de chegada.
+ * @param num_rows Número de linhas do labirinto.
+ * @param num_cols Número de colunas do labirinto.
  */
 void dfs(Graph* graph, int start_node, int end_node, int num_rows, int num_cols) {
     printf("\n--- Iniciando Busca em Profundidade (DFS) ---\n");
@@ -317,98 +701,3574 @@ void dfs(Graph* graph, int start_node, int end_node, int num_rows, int num_cols)
 
     if (dfs_recursive(graph, start_node, end_node, visited, parent, num_cols)) {
         printf("Caminho encontrado por DFS:\n");
-        print_path(parent, start_node, end_node, num_cols);
+        print_path(parent, start_node, end_node, num_cols, NEIGHBORHOOD_4);
     } else {
         printf("Nenhum caminho encontrado por DFS.\n");
     }
 }
+/**
+ * @brief BFS com múltiplas origens: distância de cada célula à origem mais próxima.
+ *
+ * Todas as origens entram na fila com distância 0, de modo que uma única passada
+ * O(V + E) produz o campo de distâncias completo. A fila é um array simples: cada
+ * nó é enfileirado no máximo uma vez, então num_nodes posições bastam.
+ *
+ * @param graph O grafo que representa o labirinto.
+ * @param sources Os índices dos nós de origem (por exemplo, todas as saídas 'E').
+ * @param num_sources O número de origens.
+ * @param dist Saída: distância em passos até a origem mais próxima (-1 se inalcançável ou parede).
+ * @param nearest Saída opcional (NULL): posição em sources da origem mais próxima (-1 se inalcançável).
+ * @param parent Saída opcional (NULL): predecessor de cada nó no caminho mais curto.
+ */
+void multi_source_bfs(Graph* graph, const int sources[], int num_sources, int dist[], int nearest[], int parent[]) {
+    int* queue = (int*)malloc(graph->num_nodes * sizeof(int));
+    if (!queue) {
+        perror("Erro ao alocar fila da BFS");
+        exit(EXIT_FAILURE);
+    }
 
+    for (int i = 0; i < graph->num_nodes; i++) {
+        dist[i] = -1;
+        if (nearest) nearest[i] = -1;
+        if (parent) parent[i] = -1;
+    }
 
-// --- Funo Principal ---
+    int head = 0, tail = 0;
+    for (int i = 0; i < num_sources; i++) {
+        if (dist[sources[i]] == -1) { // Ignora origens repetidas
+            dist[sources[i]] = 0;
+            if (nearest) nearest[sources[i]] = i;
+            queue[tail++] = sources[i];
+        }
+    }
 
-int main() {
-    // Exemplo de labirinto (pode ser ajustado)
-    char maze[MAX_ROWS][MAX_COLS] = {
-        {'#', '#', '#', '#', '#', '#', '#', '#', '#', '#'},
-        {'#', 'S', ' ', '#', ' ', ' ', ' ', '#', 'E', '#'},
-        {'#', ' ', ' ', '#', ' ', '#', ' ', '#', ' ', '#'},
-        {'#', ' ', '#', '#', ' ', '#', ' ', ' ', ' ', '#'},
-        {'#', ' ', ' ', ' ', ' ', ' ', ' ', '#', ' ', '#'},
-        {'#', '#', '#', '#', '#', '#', ' ', '#', ' ', '#'},
-        {'#', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '#'},
-        {'#', ' ', '#', '#', '#', '#', '#', '#', ' ', '#'},
-        {'#', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '#'},
-        {'#', '#', '#', '#', '#', '#', '#', '#', '#', '#'}
-    };
+    while (head < tail) {
+        int u = queue[head++];
+        for (AdjListNode* temp = graph->adj_lists[u]; temp; temp = temp->next) {
+            int v = temp->dest;
+            if (dist[v] == -1) {
+                dist[v] = dist[u] + 1;
+                if (nearest) nearest[v] = nearest[u];
+                if (parent) parent[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+    free(queue);
+}
 
-    int num_rows = 10;
-    int num_cols = 10;
-    int num_nodes = num_rows * num_cols;
+// --- Fila de Prioridade (Heap Binário) ---
+
+// Heap binário de mínimo indexado pelo nó, com diminuição de chave em O(log n)
+typedef struct MinHeap {
+    int size;
+    int capacity;
+    int* nodes;    // Nós em ordem de heap
+    int* keys;     // Chave (distância) de cada nó
+    int* position; // Posição de cada nó em 'nodes', ou -1 se ausente
+} MinHeap;
+
+// Cria um heap para nós de 0 a capacity - 1
+MinHeap* create_min_heap(int capacity) {
+    MinHeap* heap = (MinHeap*)malloc(sizeof(MinHeap));
+    if (!heap) {
+        perror("Erro ao alocar heap");
+        exit(EXIT_FAILURE);
+    }
+    heap->size = 0;
+    heap->capacity = capacity;
+    heap->nodes = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    heap->keys = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    heap->position = (int*)malloc((capacity > 0 ? capacity : 1) * sizeof(int));
+    if (!heap->nodes || !heap->keys || !heap->position) {
+        perror("Erro ao alocar heap");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < capacity; i++) {
+        heap->position[i] = -1;
+    }
+    return heap;
+}
 
-    Graph* graph = create_graph(num_nodes);
+// Troca dois elementos do heap, atualizando suas posições
+void heap_swap(MinHeap* heap, int i, int j) {
+    int temp = heap->nodes[i];
+    heap->nodes[i] = heap->nodes[j];
+    heap->nodes[j] = temp;
+    heap->position[heap->nodes[i]] = i;
+    heap->position[heap->nodes[j]] = j;
+}
 
-    int start_node = -1;
-    int end_node = -1;
+// Insere o nó com a chave dada, ou diminui sua chave se já estiver no heap
+void heap_push_or_decrease(MinHeap* heap, int node, int key) {
+    int i = heap->position[node];
+    if (i == -1) {
+        i = heap->size++;
+        heap->nodes[i] = node;
+        heap->position[node] = i;
+    } else if (key >= heap->keys[node]) {
+        return;
+    }
+    heap->keys[node] = key;
+    while (i > 0 && heap->keys[heap->nodes[(i - 1) / 2]] > key) {
+        heap_swap(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
 
-    // Direes: Cima, Baixo, Esquerda, Direita
-    int dr[] = {-1, 1, 0, 0};
-    int dc[] = {0, 0, -1, 1};
+// Remove e retorna o nó de menor chave
+int heap_pop_min(MinHeap* heap) {
+    int min_node = heap->nodes[0];
+    heap->size--;
+    heap_swap(heap, 0, heap->size);
+    heap->position[min_node] = -1;
 
-    // Construir o grafo a partir do labirinto
-    for (int r = 0; r < num_rows; r++) {
-        for (int c = 0; c < num_cols; c++) {
-            if (maze[r][c] == '#') {
-                continue; // Paredes no so ns
+    int i = 0;
+    while (true) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+        if (left < heap->size && heap->keys[heap->nodes[left]] < heap->keys[heap->nodes[smallest]]) {
+            smallest = left;
+        }
+        if (right < heap->size && heap->keys[heap->nodes[right]] < heap->keys[heap->nodes[smallest]]) {
+            smallest = right;
+        }
+        if (smallest == i) break;
+        heap_swap(heap, i, smallest);
+        i = smallest;
+    }
+    return min_node;
+}
+
+// Verifica se o heap está vazio
+bool is_empty_heap(const MinHeap* heap) {
+    return heap->size == 0;
+}
+
+// Libera a memória do heap
+void free_min_heap(MinHeap* heap) {
+    if (!heap) return;
+    free(heap->nodes);
+    free(heap->keys);
+    free(heap->position);
+    free(heap);
+}
+
+// --- Grafo de Junções (Becos Preenchidos e Corredores Contraídos) ---
+
+// Próxima célula do corredor: o vizinho restante de 'cell' diferente de 'previous'
+static int corridor_next(const Graph* graph, const bool removed[], int cell, int previous) {
+    for (AdjListNode* temp = graph->adj_lists[cell]; temp; temp = temp->next) {
+        if (!removed[temp->dest] && temp->dest != previous) {
+            return temp->dest;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Reduz o grafo do labirinto a um grafo ponderado só com as junções.
+ *
+ * 1. Preenchimento de becos: células de grau 1 são removidas repetidamente
+ *    (nenhum caminho simples entre start e end passa por um beco).
+ * 2. Contração: as células restantes de grau 2 formam corredores; cada
+ *    corredor vira uma aresta entre as junções das pontas (grau != 2), com
+ *    peso igual ao número de passos. start e end são sempre junções.
+ *
+ * @param graph O grafo de células.
+ * @param start_node Célula de partida (mantida).
+ * @param end_node Célula de chegada (mantida).
+ * @return O grafo de junções, em listas de arestas contíguas (CSR).
+ */
+JunctionGraph* contract_maze_graph(const Graph* graph, int start_node, int end_node) {
+    int num_nodes = graph->num_nodes;
+    JunctionGraph* jg = (JunctionGraph*)malloc(sizeof(JunctionGraph));
+    int* degree = (int*)malloc(num_nodes * sizeof(int));
+    int* stack = (int*)malloc(num_nodes * sizeof(int));
+    if (!jg || !degree || !stack) {
+        perror("Erro ao alocar grafo de junções");
+        exit(EXIT_FAILURE);
+    }
+    jg->num_cells = num_nodes;
+    jg->removed = (bool*)malloc(num_nodes * sizeof(bool));
+    jg->junction_of = (int*)malloc(num_nodes * sizeof(int));
+    if (!jg->removed || !jg->junction_of) {
+        perror("Erro ao alocar grafo de junções");
+        exit(EXIT_FAILURE);
+    }
+
+    // Preenchimento de becos: pilha de células de grau <= 1 ainda não removidas
+    int top = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        degree[i] = 0;
+        for (AdjListNode* temp = graph->adj_lists[i]; temp; temp = temp->next) {
+            degree[i]++;
+        }
+        jg->removed[i] = false;
+        if (degree[i] <= 1 && i != start_node && i != end_node) {
+            jg->removed[i] = true;
+            stack[top++] = i;
+        }
+    }
+    while (top > 0) {
+        int cell = stack[--top];
+        for (AdjListNode* temp = graph->adj_lists[cell]; temp; temp = temp->next) {
+            int v = temp->dest;
+            if (!jg->removed[v] && --degree[v] <= 1 && v != start_node && v != end_node) {
+                jg->removed[v] = true;
+                stack[top++] = v;
             }
+        }
+    }
 
-            int u = map_coord_to_index(r, c, num_cols);
+    // Junções: células restantes de grau diferente de 2, mais start e end
+    jg->num_junctions = 0;
+    for (int i = 0; i < num_nodes; i++) {
+        bool junction = !jg->removed[i] && (degree[i] != 2 || i == start_node || i == end_node);
+        jg->junction_of[i] = junction ? jg->num_junctions++ : -1;
+        jg->num_cells -= jg->removed[i];
+    }
+    jg->junction_cell = (int*)malloc((jg->num_junctions > 0 ? jg->num_junctions : 1) * sizeof(int));
+    jg->edge_offset = (int*)malloc((jg->num_junctions + 1) * sizeof(int));
+    if (!jg->junction_cell || !jg->edge_offset) {
+        perror("Erro ao alocar grafo de junções");
+        exit(EXIT_FAILURE);
+    }
+    int num_edges = 0; // No máximo uma aresta por saída de cada junção
+    for (int i = 0; i < num_nodes; i++) {
+        int j = jg->junction_of[i];
+        if (j >= 0) {
+            jg->junction_cell[j] = i;
+            num_edges += degree[i];
+        }
+    }
+
+    // Contração: percorre cada corredor a partir das duas pontas
+    jg->edge_target = (int*)malloc((num_edges > 0 ? num_edges : 1) * sizeof(int));
+    jg->edge_weight = (int*)malloc((num_edges > 0 ? num_edges : 1) * sizeof(int));
+    jg->edge_first = (int*)malloc((num_edges > 0 ? num_edges : 1) * sizeof(int));
+    if (!jg->edge_target || !jg->edge_weight || !jg->edge_first) {
+        perror("Erro ao alocar arestas de junções");
+        exit(EXIT_FAILURE);
+    }
+    int e = 0;
+    jg->edge_offset[0] = 0;
+    for (int j = 0; j < jg->num_junctions; j++) {
+        int source = jg->junction_cell[j];
+        for (AdjListNode* temp = graph->adj_lists[source]; temp; temp = temp->next) {
+            if (jg->removed[temp->dest]) continue;
+            int previous = source, cell = temp->dest, weight = 1;
+            while (jg->junction_of[cell] < 0) {
+                int next = corridor_next(graph, jg->removed, cell, previous);
+                previous = cell;
+                cell = next;
+                weight++;
+            }
+            if (cell == source) continue; // Laço que volta à mesma junção: nunca é mais curto
+            jg->edge_target[e] = jg->junction_of[cell];
+            jg->edge_weight[e] = weight;
+            jg->edge_first[e] = temp->dest;
+            e++;
+        }
+        jg->edge_offset[j + 1] = e;
+    }
+    jg->num_edges = e;
+    free(degree);
+    free(stack);
+    return jg;
+}
+
+// Libera a memória do grafo de junções
+void free_junction_graph(JunctionGraph* jg) {
+    if (!jg) return;
+    free(jg->removed);
+    free(jg->junction_of);
+    free(jg->junction_cell);
+    free(jg->edge_offset);
+    free(jg->edge_target);
+    free(jg->edge_weight);
+    free(jg->edge_first);
+    free(jg);
+}
 
-            if (maze[r][c] == 'S') {
-                start_node = u;
-            } else if (maze[r][c] == 'E') {
-                end_node = u;
+/**
+ * @brief Dijkstra (heap binário) no grafo de junções, expandido de volta para células.
+ *
+ * Os corredores do caminho encontrado são percorridos de novo célula a célula
+ * para preencher parent[], no mesmo formato de bfs/dfs, de modo que print_path
+ * funcione sem alterações.
+ *
+ * @param graph O grafo de células usado na contração.
+ * @param jg O grafo de junções de contract_maze_graph(graph, start_node, end_node).
+ * @param start_node Célula de partida.
+ * @param end_node Célula de chegada.
+ * @param parent Saída com graph->num_nodes posições: predecessores ao longo do caminho.
+ * @return A distância em passos, ou -1 se não houver caminho.
+ */
+int junction_dijkstra(const Graph* graph, const JunctionGraph* jg, int start_node, int end_node, int parent[]) {
+    for (int i = 0; i < graph->num_nodes; i++) {
+        parent[i] = -1;
+    }
+    int source = jg->junction_of[start_node];
+    int target = jg->junction_of[end_node];
+    if (source < 0 || target < 0) {
+        return -1;
+    }
+    int n = jg->num_junctions;
+    int* dist = (int*)malloc(n * sizeof(int));
+    int* via_edge = (int*)malloc(n * sizeof(int)); // Aresta pela qual a junção foi alcançada
+    int* via_junction = (int*)malloc(n * sizeof(int));
+    if (!dist || !via_edge || !via_junction) {
+        perror("Erro ao alocar Dijkstra de junções");
+        exit(EXIT_FAILURE);
+    }
+    for (int j = 0; j < n; j++) {
+        dist[j] = -1;
+        via_edge[j] = -1;
+    }
+    MinHeap* heap = create_min_heap(n);
+    dist[source] = 0;
+    heap_push_or_decrease(heap, source, 0);
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        if (u == target) break;
+        for (int e = jg->edge_offset[u]; e < jg->edge_offset[u + 1]; e++) {
+            int v = jg->edge_target[e];
+            int candidate = dist[u] + jg->edge_weight[e];
+            if (dist[v] == -1 || candidate < dist[v]) {
+                dist[v] = candidate;
+                via_edge[v] = e;
+                via_junction[v] = u;
+                heap_push_or_decrease(heap, v, candidate);
             }
+        }
+    }
+    free_min_heap(heap);
 
-            // Adicionar arestas para vizinhos vlidos
-            for (int i = 0; i < 4; i++) {
-                int nr = r + dr[i]; // Nova linha
-                int nc = c + dc[i]; // Nova coluna
-
-                if (is_valid(nr, nc, num_rows, num_cols) && maze[nr][nc] != '#') {
-                    int v = map_coord_to_index(nr, nc, num_cols);
-                    // No adicionar a aresta duas vezes se j existir no grafo
-                    // (A funo add_edge j adiciona bidirecionalmente)
-                    // Poderamos verificar se j existe, mas para este caso simples,
-                    // adicionar duas vezes no causa erro, apenas redundncia de memria.
-                    // Para um grafo mais complexo, seria necessrio verificar.
-                    add_edge(graph, u, v);
-                }
+    int distance = dist[target];
+    if (distance >= 0) {
+        // Expande cada aresta do caminho de volta para os corredores de células
+        for (int j = target; j != source; j = via_junction[j]) {
+            int e = via_edge[j];
+            int previous = jg->junction_cell[via_junction[j]];
+            int cell = jg->edge_first[e];
+            while (true) {
+                parent[cell] = previous;
+                if (jg->junction_of[cell] >= 0) break;
+                int next = corridor_next(graph, jg->removed, cell, previous);
+                previous = cell;
+                cell = next;
             }
         }
     }
+    free(dist);
+    free(via_edge);
+    free(via_junction);
+    return distance;
+}
 
-    if (start_node == -1 || end_node == -1) {
-        printf("Erro: Ponto de partida 'S' ou de chegada 'E' no encontrado no labirinto.\n");
-        free_graph(graph);
-        return 1;
+// Resolve o labirinto pelo grafo de junções e imprime o caminho como bfs/dfs
+void contracted_search(Graph* graph, int start_node, int end_node, int num_cols) {
+    printf("\n--- Iniciando Busca no Grafo de Junções (Dijkstra) ---\n");
+    JunctionGraph* jg = contract_maze_graph(graph, start_node, end_node);
+    printf("Células após preencher becos: %d; junções: %d; arestas: %d.\n", jg->num_cells, jg->num_junctions,
+           jg->num_edges / 2);
+    int* parent = (int*)malloc(graph->num_nodes * sizeof(int));
+    if (!parent) {
+        perror("Erro ao alocar predecessores");
+        exit(EXIT_FAILURE);
+    }
+    int distance = junction_dijkstra(graph, jg, start_node, end_node, parent);
+    if (distance >= 0) {
+        printf("Caminho encontrado pelo grafo de junções (%d passos):\n", distance);
+        print_path(parent, start_node, end_node, num_cols, NEIGHBORHOOD_4);
+    } else {
+        printf("Nenhum caminho encontrado pelo grafo de junções.\n");
     }
+    free(parent);
+    free_junction_graph(jg);
+}
 
-    printf("Labirinto:\n");
-    for (int r = 0; r < num_rows; r++) {
-        for (int c = 0; c < num_cols; c++) {
-            printf("%c ", maze[r][c]);
+// --- Campo de Distâncias (Exportação e Carga) ---
+
+// Formato binário: "BFSD", linhas, colunas e origem (int32), seguidos de
+// dist[] e parent[] (int32, uma entrada por célula, na ordem dos índices).
+static const char DISTANCE_FIELD_MAGIC[4] = {'B', 'F', 'S', 'D'};
+
+// Aloca um campo de distâncias vazio para um labirinto num_rows x num_cols
+// (um elemento por índice de layout_num_cells)
+DistanceField* create_distance_field(int num_rows, int num_cols, int start_node) {
+    DistanceField* field = (DistanceField*)malloc(sizeof(DistanceField));
+    if (!field) {
+        perror("Erro ao alocar campo de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    field->num_rows = num_rows;
+    field->num_cols = num_cols;
+    field->start_node = start_node;
+    size_t num_cells = (size_t)layout_num_cells(num_rows, num_cols);
+    field->dist = (int*)malloc(num_cells * sizeof(int));
+    field->parent = (int*)malloc(num_cells * sizeof(int));
+    if (!field->dist || !field->parent) {
+        perror("Erro ao alocar campo de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    return field;
+}
+
+// Libera a memória do campo de distâncias
+void free_distance_field(DistanceField* field) {
+    if (!field) return;
+    free(field->dist);
+    free(field->parent);
+    free(field);
+}
+
+/**
+ * @brief Executa a BFS completa a partir de start_node, sem parar em nenhum destino.
+ *
+ * @param graph O grafo que representa o labirinto.
+ * @param start_node O índice do nó de partida.
+ * @param num_rows Número de linhas do labirinto.
+ * @param num_cols Número de colunas do labirinto.
+ * @return O campo com dist/parent de todas as células; o caminho até qualquer
+ *         célula sai direto de parent[], sem nova busca.
+ */
+DistanceField* compute_distance_field(Graph* graph, int start_node, int num_rows, int num_cols) {
+    DistanceField* field = create_distance_field(num_rows, num_cols, start_node);
+    multi_source_bfs(graph, &start_node, 1, field->dist, NULL, field->parent);
+    return field;
+}
+
+// Índice de nó -> posição linha a linha (formato do arquivo); -1 permanece -1
+static inline int32_t index_to_file_order(int index, int num_cols) {
+    if (index < 0) return -1;
+    Cell cell;
+    map_index_to_coord(index, num_cols, &cell);
+    return (int32_t)cell.row * num_cols + cell.col;
+}
+
+// Grava o campo no formato binário; retorna 0 em caso de sucesso, -1 em erro.
+// O arquivo é sempre linha a linha, independente da disposição em memória.
+int save_distance_field(const DistanceField* field, const char* filename) {
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        perror("Erro ao criar arquivo do campo de distâncias");
+        return -1;
+    }
+    int num_cols = field->num_cols;
+    int32_t* row = (int32_t*)malloc(num_cols * sizeof(int32_t));
+    if (!row) {
+        perror("Erro ao alocar linha do campo de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    int32_t header[3] = {field->num_rows, num_cols, index_to_file_order(field->start_node, num_cols)};
+    bool ok = fwrite(DISTANCE_FIELD_MAGIC, 1, 4, file) == 4 &&
+              fwrite(header, sizeof(int32_t), 3, file) == 3;
+    for (int pass = 0; pass < 2 && ok; pass++) { // pass 0: dist[]; pass 1: parent[]
+        for (int r = 0; r < field->num_rows && ok; r++) {
+            for (int c = 0; c < num_cols; c++) {
+                int index = map_coord_to_index(r, c, num_cols);
+                row[c] = pass == 0 ? field->dist[index] : index_to_file_order(field->parent[index], num_cols);
+            }
+            ok = fwrite(row, sizeof(int32_t), num_cols, file) == (size_t)num_cols;
         }
-        printf("\n");
     }
+    free(row);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar '%s'.\n", filename);
+        return -1;
+    }
+    return 0;
+}
 
-    // Executar BFS
-    bfs(graph, start_node, end_node, num_rows, num_cols);
+// Carrega um campo gravado por save_distance_field; retorna NULL em erro
+DistanceField* load_distance_field(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        perror("Erro ao abrir arquivo do campo de distâncias");
+        return NULL;
+    }
+    char magic[4];
+    int32_t header[3];
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, DISTANCE_FIELD_MAGIC, 4) != 0 ||
+        fread(header, sizeof(int32_t), 3, file) != 3 || header[0] <= 0 || header[1] <= 0 ||
+        header[2] < 0 || (int64_t)header[2] >= (int64_t)header[0] * header[1]) {
+        fprintf(stderr, "Arquivo '%s' não é um campo de distâncias válido.\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    int num_rows = header[0], num_cols = header[1];
+    int64_t num_cells = (int64_t)num_rows * num_cols;
+    DistanceField* field = create_distance_field(num_rows, num_cols,
+                                                 map_coord_to_index(header[2] / num_cols, header[2] % num_cols, num_cols));
+    int32_t* row = (int32_t*)malloc(num_cols * sizeof(int32_t));
+    if (!row) {
+        perror("Erro ao alocar linha do campo de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < layout_num_cells(num_rows, num_cols); i++) {
+        field->dist[i] = -1; // Lacunas da disposição em blocos/Morton
+        field->parent[i] = -1;
+    }
 
-    // Executar DFS
-    dfs(graph, start_node, end_node, num_rows, num_cols);
+    bool ok = true;
+    for (int pass = 0; pass < 2 && ok; pass++) {
+        for (int r = 0; r < num_rows && ok; r++) {
+            ok = fread(row, sizeof(int32_t), num_cols, file) == (size_t)num_cols;
+            for (int c = 0; c < num_cols && ok; c++) {
+                int index = map_coord_to_index(r, c, num_cols);
+                if (pass == 0) {
+                    field->dist[index] = row[c];
+                } else if (row[c] < -1 || row[c] >= num_cells) {
+                    ok = false;
+                } else {
+                    field->parent[index] = row[c] < 0 ? -1 : map_coord_to_index(row[c] / num_cols, row[c] % num_cols, num_cols);
+                }
+            }
+        }
+    }
+    free(row);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Arquivo '%s' truncado ou inválido.\n", filename);
+        free_distance_field(field);
+        return NULL;
+    }
+    return field;
+}
+
+/**
+ * @brief Grava o campo como imagem PGM binária (P5) em tons de cinza.
+ *
+ * Cada pixel vale distância + 1 (0 para paredes e células inalcançáveis). Usa
+ * 8 bits por pixel quando a maior distância cabe, senão 16 bits (big-endian,
+ * como exige o formato), saturando em 65535.
+ *
+ * @param field O campo de distâncias.
+ * @param filename O arquivo de saída.
+ * @return 0 em caso de sucesso, -1 em erro.
+ */
+int save_distance_field_pgm(const DistanceField* field, const char* filename) {
+    size_t num_cells = (size_t)layout_num_cells(field->num_rows, field->num_cols);
+    int max_value = 1;
+    for (size_t i = 0; i < num_cells; i++) {
+        if (field->dist[i] + 1 > max_value) {
+            max_value = field->dist[i] + 1;
+        }
+    }
+    if (max_value > 65535) {
+        max_value = 65535;
+    }
+    int bytes_per_pixel = max_value < 256 ? 1 : 2;
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        perror("Erro ao criar imagem PGM");
+        return -1;
+    }
+    fprintf(file, "P5\n%d %d\n%d\n", field->num_cols, field->num_rows, max_value);
+
+    // Converte uma linha por vez para um buffer e grava em bloco
+    unsigned char* row = (unsigned char*)malloc((size_t)field->num_cols * bytes_per_pixel);
+    if (!row) {
+        perror("Erro ao alocar linha da imagem PGM");
+        exit(EXIT_FAILURE);
+    }
+    bool ok = true;
+    for (int r = 0; r < field->num_rows && ok; r++) {
+        for (int c = 0; c < field->num_cols; c++) {
+            int value = field->dist[map_coord_to_index(r, c, field->num_cols)] + 1;
+            if (value > max_value) {
+                value = max_value;
+            }
+            if (bytes_per_pixel == 1) {
+                row[c] = (unsigned char)value;
+            } else {
+                row[2 * c] = (unsigned char)(value >> 8);
+                row[2 * c + 1] = (unsigned char)(value & 0xFF);
+            }
+        }
+        ok = fwrite(row, bytes_per_pixel, field->num_cols, file) == (size_t)field->num_cols;
+    }
+    free(row);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar '%s'.\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// --- Gerador de Números Aleatórios ---
+
+// Inicializa o gerador; a mesma semente reproduz o mesmo labirinto em qualquer plataforma
+void rng_seed(Rng* rng, uint64_t seed) {
+    // Um passo de splitmix64 espalha sementes pequenas e evita o estado 0
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    rng->state = z ? z : 0x9E3779B97F4A7C15ULL;
+}
+
+// Próximo valor de 64 bits (xorshift64*)
+uint64_t rng_next(Rng* rng) {
+    rng->state ^= rng->state >> 12;
+    rng->state ^= rng->state << 25;
+    rng->state ^= rng->state >> 27;
+    return rng->state * 0x2545F4914F6CDD1DULL;
+}
+
+// Inteiro uniforme em [0, bound), por multiplicação (sem divisão)
+uint32_t rng_below(Rng* rng, uint32_t bound) {
+    return (uint32_t)(((rng_next(rng) >> 32) * (uint64_t)bound) >> 32);
+}
+
+// --- Labirinto Compacto (Bitmap) ---
+
+/**
+ * @brief Cria um bitmap de labirinto num_rows x num_cols.
+ *
+ * Os bits além da última coluna de cada linha ficam sempre como parede, para
+ * que operações por palavra não precisem de tratamento especial na borda.
+ *
+ * @param num_rows Número de linhas.
+ * @param num_cols Número de colunas.
+ * @param all_walls true para começar todo em parede, false para todo aberto.
+ * @return O bitmap alocado.
+ */
+MazeBitmap* create_maze_bitmap(int num_rows, int num_cols, bool all_walls) {
+    MazeBitmap* maze = (MazeBitmap*)malloc(sizeof(MazeBitmap));
+    if (!maze) {
+        perror("Erro ao alocar bitmap do labirinto");
+        exit(EXIT_FAILURE);
+    }
+    maze->num_rows = num_rows;
+    maze->num_cols = num_cols;
+    maze->words_per_row = (num_cols + 63) / 64;
+    size_t num_words = (size_t)num_rows * maze->words_per_row;
+    maze->bits = (uint64_t*)malloc(num_words * sizeof(uint64_t));
+    if (!maze->bits) {
+        perror("Erro ao alocar bitmap do labirinto");
+        exit(EXIT_FAILURE);
+    }
+    memset(maze->bits, all_walls ? 0xFF : 0x00, num_words * sizeof(uint64_t));
+
+    // Colunas de preenchimento da última palavra de cada linha: parede
+    int tail_bits = num_cols % 64;
+    if (!all_walls && tail_bits != 0) {
+        uint64_t padding = ~0ULL << tail_bits;
+        for (int r = 0; r < num_rows; r++) {
+            maze->bits[(size_t)r * maze->words_per_row + maze->words_per_row - 1] = padding;
+        }
+    }
+    return maze;
+}
+
+// Ponteiro para a primeira palavra da linha r
+static inline uint64_t* bitmap_row(const MazeBitmap* maze, int r) {
+    return &maze->bits[(size_t)r * maze->words_per_row];
+}
+
+// Verifica se (r, c) é parede
+static inline bool bitmap_is_wall(const MazeBitmap* maze, int r, int c) {
+    return (bitmap_row(maze, r)[c >> 6] >> (c & 63)) & 1;
+}
+
+// Marca (r, c) como parede
+static inline void bitmap_set_wall(MazeBitmap* maze, int r, int c) {
+    bitmap_row(maze, r)[c >> 6] |= 1ULL << (c & 63);
+}
+
+// Marca (r, c) como aberta
+static inline void bitmap_clear_wall(MazeBitmap* maze, int r, int c) {
+    bitmap_row(maze, r)[c >> 6] &= ~(1ULL << (c & 63));
+}
+
+// Libera a memória do bitmap
+void free_maze_bitmap(MazeBitmap* maze) {
+    if (!maze) return;
+    free(maze->bits);
+    free(maze);
+}
+
+// Índice do bit menos significativo ligado (x != 0)
+static inline int lowest_bit(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+// Células abertas da palavra w cuja vizinha à direita também está aberta
+// (a vizinha da coluna 63 é o bit 0 da palavra seguinte)
+static inline uint64_t open_right_mask(const uint64_t* row, int w, int words_per_row) {
+    uint64_t open = ~row[w];
+    uint64_t next = w + 1 < words_per_row ? ~row[w + 1] : 0;
+    return open & ((open >> 1) | (next << 63));
+}
+
+// Células abertas da palavra w cuja vizinha de baixo também está aberta
+static inline uint64_t open_down_mask(const uint64_t* row, const uint64_t* below, int w) {
+    return ~row[w] & ~below[w];
+}
+
+// --- Labirinto Compacto com Partida e Saídas ---
+
+// Cria um labirinto compacto sobre 'walls' (que passa a pertencer a ele), sem S nem E
+PackedMaze* create_packed_maze(MazeBitmap* walls) {
+    PackedMaze* maze = (PackedMaze*)malloc(sizeof(PackedMaze));
+    if (!maze) {
+        perror("Erro ao alocar labirinto compacto");
+        exit(EXIT_FAILURE);
+    }
+    maze->walls = walls;
+    maze->start.row = maze->start.col = -1;
+    maze->end.row = maze->end.col = -1;
+    maze->exits = NULL;
+    maze->num_exits = 0;
+    maze->exits_capacity = 0;
+    maze->cost = NULL;
+    return maze;
+}
+
+// Libera a memória do labirinto compacto (inclusive o bitmap)
+void free_packed_maze(PackedMaze* maze) {
+    if (!maze) return;
+    free_maze_bitmap(maze->walls);
+    free(maze->exits);
+    free(maze->cost);
+    free(maze);
+}
+
+// Registra uma saída; a última registrada é a chegada padrão (end)
+void packed_maze_add_exit(PackedMaze* maze, int r, int c) {
+    if (maze->num_exits == maze->exits_capacity) {
+        maze->exits_capacity = maze->exits_capacity ? maze->exits_capacity * 2 : 4;
+        maze->exits = (Cell*)realloc(maze->exits, maze->exits_capacity * sizeof(Cell));
+        if (!maze->exits) {
+            perror("Erro ao realocar saídas do labirinto");
+            exit(EXIT_FAILURE);
+        }
+    }
+    maze->exits[maze->num_exits].row = r;
+    maze->exits[maze->num_exits].col = c;
+    maze->num_exits++;
+    maze->end.row = r;
+    maze->end.col = c;
+}
+
+// Custo de entrar na célula (r, c); 1 em labirintos sem terreno
+static inline int packed_maze_cost(const PackedMaze* maze, int r, int c) {
+    return maze->cost ? maze->cost[map_coord_to_index(r, c, maze->walls->num_cols)] : 1;
+}
+
+// Aplica um caractere do formato texto à célula (r, c): '#' parede, 'S' partida,
+// 'E' saída, '1'-'9' terreno com esse custo (' ', 'S' e 'E' custam 1)
+static void packed_maze_set_char(PackedMaze* maze, int r, int c, char ch) {
+    if (ch == '#') {
+        bitmap_set_wall(maze->walls, r, c);
+        return;
+    }
+    bitmap_clear_wall(maze->walls, r, c);
+    int cost = ch >= '1' && ch <= '9' ? ch - '0' : 1;
+    if (cost > 1 && !maze->cost) {
+        // Primeiro terreno do labirinto: a grade de custos nasce toda com custo 1
+        size_t num_cells = (size_t)layout_num_cells(maze->walls->num_rows, maze->walls->num_cols);
+        maze->cost = (unsigned char*)malloc(num_cells);
+        if (!maze->cost) {
+            perror("Erro ao alocar custos do terreno");
+            exit(EXIT_FAILURE);
+        }
+        memset(maze->cost, 1, num_cells);
+    }
+    if (maze->cost) {
+        maze->cost[map_coord_to_index(r, c, maze->walls->num_cols)] = (unsigned char)cost;
+    }
+    if (ch == 'S') {
+        maze->start.row = r;
+        maze->start.col = c;
+    } else if (ch == 'E') {
+        packed_maze_add_exit(maze, r, c);
+    }
+}
+
+/**
+ * @brief Converte uma grade de caracteres ('#', ' ', 'S', 'E', '1'-'9') para o formato compacto.
+ *
+ * @param cells A grade, linha a linha.
+ * @param num_rows Número de linhas.
+ * @param num_cols Número de colunas.
+ * @param stride Distância, em caracteres, entre o início de duas linhas.
+ * @return O labirinto compacto; start.row é -1 e num_exits é 0 se faltarem S ou E.
+ */
+PackedMaze* pack_maze(const char* cells, int num_rows, int num_cols, int stride) {
+    PackedMaze* maze = create_packed_maze(create_maze_bitmap(num_rows, num_cols, true));
+    for (int r = 0; r < num_rows; r++) {
+        for (int c = 0; c < num_cols; c++) {
+            packed_maze_set_char(maze, r, c, cells[(size_t)r * stride + c]);
+        }
+    }
+    return maze;
+}
+
+// Caractere da célula (r, c) no formato texto
+char packed_maze_char(const PackedMaze* maze, int r, int c) {
+    if (bitmap_is_wall(maze->walls, r, c)) return '#';
+    if (r == maze->start.row && c == maze->start.col) return 'S';
+    for (int i = 0; i < maze->num_exits; i++) {
+        if (r == maze->exits[i].row && c == maze->exits[i].col) return 'E';
+    }
+    int cost = packed_maze_cost(maze, r, c);
+    return cost > 1 ? (char)('0' + cost) : ' ';
+}
+
+/**
+ * @brief Imprime um campo por célula (distâncias ou rótulos) no formato do labirinto.
+ *
+ * Paredes aparecem como '#' e células abertas com valor -1 (inalcançáveis) como '-'.
+ *
+ * @param maze O labirinto, para distinguir paredes de células abertas.
+ * @param values Um valor por célula, na disposição de map_coord_to_index.
+ */
+void print_cell_field(const PackedMaze* maze, const int values[]) {
+    int num_cols = maze->walls->num_cols;
+    for (int r = 0; r < maze->walls->num_rows; r++) {
+        for (int c = 0; c < num_cols; c++) {
+            int value = values[map_coord_to_index(r, c, num_cols)];
+            if (bitmap_is_wall(maze->walls, r, c)) {
+                printf("  #");
+            } else if (value == -1) {
+                printf("  -");
+            } else {
+                printf("%3d", value);
+            }
+        }
+        printf("\n");
+    }
+}
+
+// Preenche uma linha de texto (sem terminador) a partir do bitmap, sobrepondo terreno, S e E
+static void packed_maze_render_row(const PackedMaze* maze, int r, char line[]) {
+    const uint64_t* row = bitmap_row(maze->walls, r);
+    for (int c = 0; c < maze->walls->num_cols; c++) {
+        line[c] = ((row[c >> 6] >> (c & 63)) & 1) ? '#' : ' ';
+    }
+    if (maze->cost) {
+        for (int c = 0; c < maze->walls->num_cols; c++) {
+            int cost = maze->cost[map_coord_to_index(r, c, maze->walls->num_cols)];
+            if (cost > 1 && line[c] == ' ') line[c] = (char)('0' + cost);
+        }
+    }
+    for (int i = 0; i < maze->num_exits; i++) {
+        if (maze->exits[i].row == r) line[maze->exits[i].col] = 'E';
+    }
+    if (maze->start.row == r) line[maze->start.col] = 'S';
+}
+
+// Converte o labirinto compacto de volta para uma grade de caracteres
+void unpack_maze(const PackedMaze* maze, char* cells, int stride) {
+    for (int r = 0; r < maze->walls->num_rows; r++) {
+        packed_maze_render_row(maze, r, &cells[(size_t)r * stride]);
+    }
+}
+
+/**
+ * @brief Grava o labirinto em texto ('#', ' ', 'S', 'E', '1'-'9'), uma linha por linha do bitmap.
+ *
+ * @param file O arquivo de saída.
+ * @param maze O labirinto compacto.
+ */
+void write_packed_maze(FILE* file, const PackedMaze* maze) {
+    int num_cols = maze->walls->num_cols;
+    OutputBuffer* out = (OutputBuffer*)malloc(sizeof(OutputBuffer));
+    char* line = (char*)malloc(num_cols + 1);
+    if (!out || !line) {
+        perror("Erro ao alocar buffer de saída");
+        exit(EXIT_FAILURE);
+    }
+    out->file = file;
+    out->length = 0;
+    for (int r = 0; r < maze->walls->num_rows; r++) {
+        packed_maze_render_row(maze, r, line);
+        line[num_cols] = '\n';
+        output_append(out, line, num_cols + 1);
+    }
+    output_flush(out);
+    free(line);
+    free(out);
+}
+
+/**
+ * @brief Carrega um labirinto em texto diretamente para o formato compacto.
+ *
+ * O arquivo é lido duas vezes com getc: a primeira passada mede as dimensões
+ * (a largura é a da maior linha; linhas curtas são completadas com parede) e a
+ * segunda preenche o bitmap, sem guardar o texto em memória.
+ *
+ * @param filename O arquivo do labirinto.
+ * @return O labirinto compacto, ou NULL se o arquivo for inválido ou faltarem S ou E.
+ */
+PackedMaze* load_maze(const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        perror("Erro ao abrir arquivo do labirinto");
+        return NULL;
+    }
+    int num_rows = 0, num_cols = 0, col = 0, ch;
+    while ((ch = getc(file)) != EOF) {
+        if (ch == '\n') {
+            num_rows++;
+            col = 0;
+        } else if (ch != '\r' && ++col > num_cols) {
+            num_cols = col;
+        }
+    }
+    if (col > 0) {
+        num_rows++; // Última linha sem '\n'
+    }
+    if (num_rows == 0 || num_cols == 0) {
+        fprintf(stderr, "Arquivo '%s' não contém um labirinto.\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    if (!layout_fits(num_rows, num_cols)) {
+        fprintf(stderr, "Labirinto %dx%d em '%s' excede o limite de %d posições.\n", num_rows, num_cols, filename,
+                INT_MAX);
+        fclose(file);
+        return NULL;
+    }
+
+    rewind(file);
+    PackedMaze* maze = create_packed_maze(create_maze_bitmap(num_rows, num_cols, true));
+    int row = 0;
+    col = 0;
+    while ((ch = getc(file)) != EOF) {
+        if (ch == '\n') {
+            row++;
+            col = 0;
+        } else if (ch != '\r') {
+            packed_maze_set_char(maze, row, col++, (char)ch);
+        }
+    }
+    fclose(file);
+
+    if (maze->start.row < 0 || maze->num_exits == 0) {
+        fprintf(stderr, "Ponto de partida 'S' ou de chegada 'E' não encontrado em '%s'.\n", filename);
+        free_packed_maze(maze);
+        return NULL;
+    }
+    return maze;
+}
+
+/**
+ * @brief Máscara dos vizinhos abertos de (r, c): bit 0 cima, 1 baixo, 2 esquerda, 3 direita.
+ *
+ * As bordas do bitmap contam como parede.
+ */
+unsigned int packed_open_neighbors(const PackedMaze* maze, int r, int c) {
+    const MazeBitmap* walls = maze->walls;
+    unsigned int mask = 0;
+    if (r > 0 && !bitmap_is_wall(walls, r - 1, c)) mask |= 1;
+    if (r + 1 < walls->num_rows && !bitmap_is_wall(walls, r + 1, c)) mask |= 2;
+    if (c > 0 && !bitmap_is_wall(walls, r, c - 1)) mask |= 4;
+    if (c + 1 < walls->num_cols && !bitmap_is_wall(walls, r, c + 1)) mask |= 8;
+    return mask;
+}
+
+/**
+ * @brief Constrói o grafo do labirinto a partir do formato compacto.
+ *
+ * As arestas saem 64 células por vez das máscaras "aberta e vizinha à direita
+ * aberta" e "aberta e vizinha de baixo aberta"; cada corredor entra uma única
+ * vez (add_edge já cria os dois sentidos), sem as arestas duplicadas da
+ * varredura célula a célula.
+ *
+ * @param maze O labirinto compacto.
+ * @return O grafo, com um nó por célula (índices de map_coord_to_index).
+ */
+Graph* build_graph_from_packed(const PackedMaze* maze) {
+    const MazeBitmap* walls = maze->walls;
+    int num_cols = walls->num_cols;
+    Graph* graph = create_graph(layout_num_cells(walls->num_rows, num_cols));
+    for (int r = 0; r < walls->num_rows; r++) {
+        const uint64_t* row = bitmap_row(walls, r);
+        const uint64_t* below = r + 1 < walls->num_rows ? bitmap_row(walls, r + 1) : NULL;
+        for (int w = 0; w < walls->words_per_row; w++) {
+            uint64_t right = open_right_mask(row, w, walls->words_per_row);
+            uint64_t down = below ? open_down_mask(row, below, w) : 0;
+            while (right) {
+                int c = w * 64 + lowest_bit(right);
+                right &= right - 1;
+                add_edge(graph, map_coord_to_index(r, c, num_cols), map_coord_to_index(r, c + 1, num_cols));
+            }
+            while (down) {
+                int c = w * 64 + lowest_bit(down);
+                down &= down - 1;
+                add_edge(graph, map_coord_to_index(r, c, num_cols), map_coord_to_index(r + 1, c, num_cols));
+            }
+        }
+    }
+    return graph;
+}
+
+// --- Geração de Labirintos ---
+
+// Os geradores perfeitos usam a grade de "salas" nas coordenadas ímpares:
+// a sala (i, j) fica em (2i + 1, 2j + 1) e a parede entre duas salas vizinhas
+// fica no ponto médio. Uma sala ainda em parede é uma sala não visitada.
+
+// Abre a sala 'cell' e a parede entre ela e a sala 'from' (se from != -1)
+static inline void carve_room(MazeBitmap* maze, int room_cols, uint32_t from, uint32_t cell) {
+    int r = 2 * (int)(cell / room_cols) + 1;
+    int c = 2 * (int)(cell % room_cols) + 1;
+    bitmap_clear_wall(maze, r, c);
+    if (from != UINT32_MAX) {
+        int fr = 2 * (int)(from / room_cols) + 1;
+        int fc = 2 * (int)(from % room_cols) + 1;
+        bitmap_clear_wall(maze, (r + fr) / 2, (c + fc) / 2);
+    }
+}
+
+// Backtracker recursivo com pilha explícita (sem recursão, sem limite de profundidade)
+void generate_backtracker(MazeBitmap* maze, Rng* rng) {
+    int room_rows = (maze->num_rows - 1) / 2;
+    int room_cols = (maze->num_cols - 1) / 2;
+    uint32_t* stack = (uint32_t*)malloc((size_t)room_rows * room_cols * sizeof(uint32_t));
+    if (!stack) {
+        perror("Erro ao alocar pilha do gerador");
+        exit(EXIT_FAILURE);
+    }
+    size_t top = 0;
+    carve_room(maze, room_cols, UINT32_MAX, 0);
+    stack[top++] = 0;
+
+    while (top > 0) {
+        uint32_t cell = stack[top - 1];
+        int i = (int)(cell / room_cols);
+        int j = (int)(cell % room_cols);
+        uint32_t options[4];
+        int num_options = 0;
+        if (i > 0 && bitmap_is_wall(maze, 2 * i - 1, 2 * j + 1)) options[num_options++] = cell - room_cols;
+        if (i + 1 < room_rows && bitmap_is_wall(maze, 2 * i + 3, 2 * j + 1)) options[num_options++] = cell + room_cols;
+        if (j > 0 && bitmap_is_wall(maze, 2 * i + 1, 2 * j - 1)) options[num_options++] = cell - 1;
+        if (j + 1 < room_cols && bitmap_is_wall(maze, 2 * i + 1, 2 * j + 3)) options[num_options++] = cell + 1;
+
+        if (num_options == 0) {
+            top--; // Beco sem saída: retrocede
+            continue;
+        }
+        uint32_t next = options[rng_below(rng, num_options)];
+        carve_room(maze, room_cols, cell, next);
+        stack[top++] = next;
+    }
+    free(stack);
+}
+
+// Raiz do conjunto de x, com compressão de caminho por divisão ao meio
+static inline uint32_t union_find_root(uint32_t parent[], uint32_t x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+// Kruskal aleatório: paredes internas embaralhadas, removidas quando unem conjuntos distintos
+void generate_kruskal(MazeBitmap* maze, Rng* rng) {
+    int room_rows = (maze->num_rows - 1) / 2;
+    int room_cols = (maze->num_cols - 1) / 2;
+    size_t num_rooms = (size_t)room_rows * room_cols;
+    uint32_t* parent = (uint32_t*)malloc(num_rooms * sizeof(uint32_t));
+    unsigned char* rank = (unsigned char*)calloc(num_rooms, 1); // Limite superior da altura (< 32)
+    uint32_t* edges = (uint32_t*)malloc(2 * num_rooms * sizeof(uint32_t)); // sala * 2 + (0: direita, 1: abaixo)
+    if (!parent || !rank || !edges) {
+        perror("Erro ao alocar estruturas do gerador");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t num_edges = 0;
+    for (uint32_t cell = 0; cell < num_rooms; cell++) {
+        parent[cell] = cell;
+        carve_room(maze, room_cols, UINT32_MAX, cell);
+        if ((int)(cell % room_cols) + 1 < room_cols) edges[num_edges++] = cell * 2;
+        if ((int)(cell / room_cols) + 1 < room_rows) edges[num_edges++] = cell * 2 + 1;
+    }
+    for (size_t k = num_edges; k > 1; k--) { // Fisher-Yates
+        size_t swap = rng_below(rng, (uint32_t)k);
+        uint32_t tmp = edges[k - 1];
+        edges[k - 1] = edges[swap];
+        edges[swap] = tmp;
+    }
+
+    for (size_t k = 0; k < num_edges; k++) {
+        uint32_t a = edges[k] / 2;
+        uint32_t b = (edges[k] & 1) ? a + room_cols : a + 1;
+        uint32_t root_a = union_find_root(parent, a);
+        uint32_t root_b = union_find_root(parent, b);
+        if (root_a != root_b) {
+            // União por posto: a árvore mais rasa fica sob a mais profunda
+            if (rank[root_a] < rank[root_b]) {
+                parent[root_a] = root_b;
+            } else {
+                parent[root_b] = root_a;
+                rank[root_a] += rank[root_a] == rank[root_b];
+            }
+            carve_room(maze, room_cols, a, b);
+        }
+    }
+    free(parent);
+    free(rank);
+    free(edges);
+}
+
+// Wilson: passeios aleatórios com apagamento de laços (árvore geradora uniforme)
+void generate_wilson(MazeBitmap* maze, Rng* rng) {
+    int room_rows = (maze->num_rows - 1) / 2;
+    int room_cols = (maze->num_cols - 1) / 2;
+    size_t num_rooms = (size_t)room_rows * room_cols;
+    unsigned char* direction = (unsigned char*)malloc(num_rooms); // Última saída de cada sala no passeio
+    if (!direction) {
+        perror("Erro ao alocar estruturas do gerador");
+        exit(EXIT_FAILURE);
+    }
+    const int di[4] = {-1, 1, 0, 0};
+    const int dj[4] = {0, 0, -1, 1};
+
+    carve_room(maze, room_cols, UINT32_MAX, rng_below(rng, (uint32_t)num_rooms));
+    for (uint32_t origin = 0; origin < num_rooms; origin++) {
+        if (!bitmap_is_wall(maze, 2 * (int)(origin / room_cols) + 1, 2 * (int)(origin % room_cols) + 1)) {
+            continue; // Já está na árvore
+        }
+        // Passeia até tocar a árvore; sobrescrever a direção apaga os laços
+        uint32_t cell = origin;
+        while (bitmap_is_wall(maze, 2 * (int)(cell / room_cols) + 1, 2 * (int)(cell % room_cols) + 1)) {
+            int i = (int)(cell / room_cols);
+            int j = (int)(cell % room_cols);
+            int d;
+            do {
+                d = (int)rng_below(rng, 4);
+            } while (i + di[d] < 0 || i + di[d] >= room_rows || j + dj[d] < 0 || j + dj[d] >= room_cols);
+            direction[cell] = (unsigned char)d;
+            cell = (uint32_t)((i + di[d]) * room_cols + (j + dj[d]));
+        }
+        // Refaz o passeio sem laços, abrindo salas e paredes
+        cell = origin;
+        while (bitmap_is_wall(maze, 2 * (int)(cell / room_cols) + 1, 2 * (int)(cell % room_cols) + 1)) {
+            int d = direction[cell];
+            uint32_t next = (uint32_t)((int)cell + di[d] * room_cols + dj[d]);
+            carve_room(maze, room_cols, next, cell); // Abre a sala e a parede em direção a next
+            cell = next;
+        }
+    }
+    free(direction);
+}
+
+/**
+ * @brief Preenche o labirinto aleatoriamente: cada célula é parede com probabilidade 'density'.
+ *
+ * Gera 64 células por vez: com 8 palavras aleatórias como planos de bits de 64
+ * bytes aleatórios, um comparador bit a bit calcula de uma só vez a máscara
+ * "byte < limiar" (resolução de 1/256). A borda externa é sempre parede.
+ *
+ * @param maze O bitmap do labirinto.
+ * @param rng O gerador de números aleatórios.
+ * @param density Fração de paredes, entre 0 e 1.
+ */
+void generate_random_fill(MazeBitmap* maze, Rng* rng, double density) {
+    int threshold = (int)(density * 256.0 + 0.5);
+    threshold = threshold < 0 ? 0 : threshold > 256 ? 256 : threshold;
+    int tail_bits = maze->num_cols % 64;
+    uint64_t last_mask = tail_bits ? ~0ULL << tail_bits : 0;
+
+    for (int r = 0; r < maze->num_rows; r++) {
+        uint64_t* row = bitmap_row(maze, r);
+        for (int w = 0; w < maze->words_per_row; w++) {
+            uint64_t walls = ~0ULL;
+            if (threshold < 256) {
+                // Comparação x < threshold do bit mais significativo para o menos
+                uint64_t less = 0, equal = ~0ULL;
+                for (int bit = 7; bit >= 0; bit--) {
+                    uint64_t plane = rng_next(rng);
+                    if ((threshold >> bit) & 1) {
+                        less |= equal & ~plane;
+                        equal &= plane;
+                    } else {
+                        equal &= ~plane;
+                    }
+                }
+                walls = less;
+            }
+            row[w] = walls;
+        }
+        row[maze->words_per_row - 1] |= last_mask;
+        bitmap_set_wall(maze, r, 0);
+        bitmap_set_wall(maze, r, maze->num_cols - 1);
+    }
+    memset(bitmap_row(maze, 0), 0xFF, maze->words_per_row * sizeof(uint64_t));
+    memset(bitmap_row(maze, maze->num_rows - 1), 0xFF, maze->words_per_row * sizeof(uint64_t));
+}
+
+// Converte o nome do algoritmo na linha de comando; retorna -1 se desconhecido
+int parse_maze_generator(const char* name) {
+    if (strcmp(name, "backtracker") == 0) return GEN_BACKTRACKER;
+    if (strcmp(name, "kruskal") == 0) return GEN_KRUSKAL;
+    if (strcmp(name, "wilson") == 0) return GEN_WILSON;
+    if (strcmp(name, "aleatorio") == 0) return GEN_RANDOM_FILL;
+    return -1;
+}
+
+/**
+ * @brief Gera um labirinto num_rows x num_cols diretamente no bitmap.
+ *
+ * Os geradores perfeitos (backtracker, Kruskal e Wilson) exigem dimensões
+ * ímpares; com dimensões pares, a última linha/coluna fica em parede. A partida
+ * fica em (1, 1) e a chegada na última sala, no canto oposto.
+ *
+ * @param generator O algoritmo de geração.
+ * @param num_rows Número de linhas (mínimo 3, com pelo menos duas salas).
+ * @param num_cols Número de colunas (mínimo 3, com pelo menos duas salas).
+ * @param seed Semente do gerador aleatório.
+ * @param density Fração de paredes (somente para GEN_RANDOM_FILL).
+ * @return O labirinto gerado, com partida e chegada.
+ */
+PackedMaze* generate_maze(MazeGenerator generator, int num_rows, int num_cols, uint64_t seed, double density) {
+    Rng rng;
+    rng_seed(&rng, seed);
+    MazeBitmap* walls = create_maze_bitmap(num_rows, num_cols, true);
+    switch (generator) {
+        case GEN_BACKTRACKER: generate_backtracker(walls, &rng); break;
+        case GEN_KRUSKAL: generate_kruskal(walls, &rng); break;
+        case GEN_WILSON: generate_wilson(walls, &rng); break;
+        case GEN_RANDOM_FILL: generate_random_fill(walls, &rng, density); break;
+    }
+    PackedMaze* maze = create_packed_maze(walls);
+    packed_maze_set_char(maze, 1, 1, 'S');
+    packed_maze_set_char(maze, 2 * ((num_rows - 1) / 2) - 1, 2 * ((num_cols - 1) / 2) - 1, 'E');
+    return maze;
+}
+
+// Modo "gerar": ./projeto1 gerar <algoritmo> <linhas> <colunas> [semente] [densidade]
+int generate_command(int argc, char* argv[]) {
+    int generator = argc >= 5 ? parse_maze_generator(argv[2]) : -1;
+    int num_rows = argc >= 5 ? atoi(argv[3]) : 0;
+    int num_cols = argc >= 5 ? atoi(argv[4]) : 0;
+    if (generator < 0 || num_rows < 3 || num_cols < 3 || (int64_t)((num_rows - 1) / 2) * ((num_cols - 1) / 2) < 2) {
+        fprintf(stderr, "Uso: %s gerar <backtracker|kruskal|wilson|aleatorio> <linhas> <colunas> "
+                        "[semente] [densidade]\n", argv[0]);
+        return 1;
+    }
+    if (!layout_fits(num_rows, num_cols)) {
+        fprintf(stderr, "Labirinto %dx%d excede o limite de %d posições.\n", num_rows, num_cols, INT_MAX);
+        return 1;
+    }
+    uint64_t seed = argc >= 6 ? strtoull(argv[5], NULL, 10) : 1;
+    double density = argc >= 7 ? atof(argv[6]) : 0.3;
+
+    clock_t begin = clock();
+    PackedMaze* maze = generate_maze((MazeGenerator)generator, num_rows, num_cols, seed, density);
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    fprintf(stderr, "Labirinto %dx%d gerado em %.3f s (%.1f milhões de células/s).\n", num_rows, num_cols,
+            seconds, seconds > 0 ? (double)num_rows * num_cols / seconds / 1e6 : 0.0);
+
+    write_packed_maze(stdout, maze);
+    free_packed_maze(maze);
+    return 0;
+}
+
+// --- Componentes Conexos (Pré-verificação de Alcance) ---
+
+/**
+ * @brief Rotula as regiões conexas do labirinto em duas varreduras por linha.
+ *
+ * Primeira varredura: cada célula aberta herda o rótulo provisório da vizinha
+ * da esquerda ou de cima, e os dois rótulos são unidos (union-find) quando
+ * ambas estão abertas. As paredes são puladas 64 de cada vez pelas palavras do
+ * bitmap. Segunda varredura: os rótulos provisórios viram rótulos finais
+ * compactos 0..num_components-1.
+ *
+ * @param maze O labirinto compacto.
+ * @return Os rótulos por célula, na disposição de map_coord_to_index.
+ */
+MazeComponents* label_components(const PackedMaze* maze) {
+    const MazeBitmap* walls = maze->walls;
+    int num_rows = walls->num_rows;
+    int num_cols = walls->num_cols;
+    int num_cells = layout_num_cells(num_rows, num_cols);
+
+    MazeComponents* components = (MazeComponents*)malloc(sizeof(MazeComponents));
+    int* label = (int*)malloc((size_t)num_cells * sizeof(int));
+    uint32_t* parent = (uint32_t*)malloc(((size_t)num_rows * num_cols / 2 + 2) * sizeof(uint32_t));
+    if (!components || !label || !parent) {
+        perror("Erro ao alocar componentes conexos");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_cells; i++) {
+        label[i] = -1;
+    }
+
+    uint32_t num_labels = 0;
+    for (int r = 0; r < num_rows; r++) {
+        const uint64_t* row = bitmap_row(walls, r);
+        for (int w = 0; w < walls->words_per_row; w++) {
+            uint64_t open = ~row[w]; // Folgas além da última coluna são parede
+            while (open) {
+                int c = w * 64 + lowest_bit(open);
+                open &= open - 1;
+                int left = c > 0 && !bitmap_is_wall(walls, r, c - 1) ? label[map_coord_to_index(r, c - 1, num_cols)] : -1;
+                int up = r > 0 && !bitmap_is_wall(walls, r - 1, c) ? label[map_coord_to_index(r - 1, c, num_cols)] : -1;
+                int current;
+                if (left < 0 && up < 0) {
+                    current = (int)num_labels; // Nova região provisória
+                    parent[num_labels] = num_labels;
+                    num_labels++;
+                } else if (left < 0 || up < 0) {
+                    current = left < 0 ? up : left;
+                } else {
+                    uint32_t a = union_find_root(parent, (uint32_t)left);
+                    uint32_t b = union_find_root(parent, (uint32_t)up);
+                    if (a < b) parent[b] = a; // A raiz é sempre o menor rótulo
+                    else if (b < a) parent[a] = b;
+                    current = left;
+                }
+                label[map_coord_to_index(r, c, num_cols)] = current;
+            }
+        }
+    }
+
+    // Achata a floresta; como a raiz é sempre o menor rótulo, basta uma passada
+    for (uint32_t i = 0; i < num_labels; i++) {
+        parent[i] = union_find_root(parent, i);
+    }
+    // Numera as raízes na ordem em que aparecem; as demais copiam o número da raiz
+    int num_components = 0;
+    for (uint32_t i = 0; i < num_labels; i++) {
+        parent[i] = parent[i] == i ? (uint32_t)num_components++ : parent[parent[i]];
+    }
+    for (int i = 0; i < num_cells; i++) {
+        if (label[i] >= 0) {
+            label[i] = (int)parent[label[i]];
+        }
+    }
+    free(parent);
+
+    components->num_rows = num_rows;
+    components->num_cols = num_cols;
+    components->num_components = num_components;
+    components->label = label;
+    return components;
+}
+
+// Rótulo da região de (r, c), ou -1 se for parede
+static inline int component_of(const MazeComponents* components, Cell cell) {
+    return components->label[map_coord_to_index(cell.row, cell.col, components->num_cols)];
+}
+
+// Verifica em O(1) se existe caminho entre duas células
+bool same_component(const MazeComponents* components, Cell a, Cell b) {
+    int label = component_of(components, a);
+    return label >= 0 && label == component_of(components, b);
+}
+
+// Libera a memória dos componentes
+void free_maze_components(MazeComponents* components) {
+    if (!components) return;
+    free(components->label);
+    free(components);
+}
+
+// --- Busca em Grade sobre o Labirinto Compacto ---
+
+/**
+ * @brief BFS diretamente sobre o bitmap, sem construir o grafo de listas.
+ *
+ * Os vizinhos saem de packed_open_neighbors; dist/parent seguem a disposição
+ * de células escolhida na compilação (LAYOUT_MORTON, LAYOUT_TILED ou linha a
+ * linha), que é o que determina a localidade dos acessos de memória.
+ *
+ * @param maze O labirinto compacto.
+ * @param start A célula de partida.
+ * @param dist Saída com layout_num_cells posições: passos desde start (-1 se inalcançável).
+ * @param parent Saída opcional (NULL), mesmo tamanho: predecessor de cada célula.
+ * @return O número de células alcançadas.
+ */
+int grid_bfs(const PackedMaze* maze, Cell start, int dist[], int parent[]) {
+    int num_rows = maze->walls->num_rows;
+    int num_cols = maze->walls->num_cols;
+    int num_cells = layout_num_cells(num_rows, num_cols);
+    int* queue = (int*)malloc((size_t)num_rows * num_cols * sizeof(int));
+    if (!queue) {
+        perror("Erro ao alocar fila da BFS");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_cells; i++) {
+        dist[i] = -1;
+    }
+    if (parent) {
+        for (int i = 0; i < num_cells; i++) {
+            parent[i] = -1;
+        }
+    }
+
+    int head = 0, tail = 0;
+    int s = map_coord_to_index(start.row, start.col, num_cols);
+    dist[s] = 0;
+    queue[tail++] = s;
+    while (head < tail) {
+        int u = queue[head++];
+        Cell cell;
+        map_index_to_coord(u, num_cols, &cell);
+        unsigned int open = packed_open_neighbors(maze, cell.row, cell.col);
+        int neighbors[4] = {
+            (open & 1) ? map_coord_to_index(cell.row - 1, cell.col, num_cols) : -1,
+            (open & 2) ? map_coord_to_index(cell.row + 1, cell.col, num_cols) : -1,
+            (open & 4) ? map_coord_to_index(cell.row, cell.col - 1, num_cols) : -1,
+            (open & 8) ? map_coord_to_index(cell.row, cell.col + 1, num_cols) : -1
+        };
+        for (int i = 0; i < 4; i++) {
+            int v = neighbors[i];
+            if (v != -1 && dist[v] == -1) {
+                dist[v] = dist[u] + 1;
+                if (parent) parent[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+    free(queue);
+    return tail;
+}
+
+// --- Terreno com Custos (Dijkstra e A* com Fila de Baldes) ---
+
+// Fila de baldes circular (Dial): chaves inteiras em uma janela de num_buckets valores.
+// Como cada passo aumenta a chave em um valor limitado, substitui o heap nas buscas
+// sobre o terreno com inserção e remoção em O(1).
+typedef struct BucketQueue {
+    int num_buckets;
+    int count;       // Entradas em todos os baldes
+    int cursor;      // Menor chave possível ainda na fila
+    int* sizes;      // Entradas em cada balde
+    int* capacities;
+    int** items;     // Células de cada balde (pilha)
+} BucketQueue;
+
+// Cria uma fila para chaves que nunca excedem a menor chave presente em mais de num_buckets - 1
+BucketQueue* create_bucket_queue(int num_buckets) {
+    BucketQueue* queue = (BucketQueue*)malloc(sizeof(BucketQueue));
+    if (!queue) {
+        perror("Erro ao alocar fila de baldes");
+        exit(EXIT_FAILURE);
+    }
+    queue->num_buckets = num_buckets;
+    queue->count = 0;
+    queue->cursor = 0;
+    queue->sizes = (int*)calloc(num_buckets, sizeof(int));
+    queue->capacities = (int*)calloc(num_buckets, sizeof(int));
+    queue->items = (int**)calloc(num_buckets, sizeof(int*));
+    if (!queue->sizes || !queue->capacities || !queue->items) {
+        perror("Erro ao alocar fila de baldes");
+        exit(EXIT_FAILURE);
+    }
+    return queue;
+}
+
+// Insere a célula com a chave dada (chave >= última chave removida)
+void bucket_push(BucketQueue* queue, int cell, int key) {
+    // Com a fila vazia, o cursor salta para a chave (h(S) no A* pode estar além da
+    // janela); chaves menores inseridas em seguida o trazem de volta
+    if (queue->count == 0 || key < queue->cursor) {
+        queue->cursor = key;
+    }
+    int b = key % queue->num_buckets;
+    if (queue->sizes[b] == queue->capacities[b]) {
+        queue->capacities[b] = queue->capacities[b] ? queue->capacities[b] * 2 : 64;
+        queue->items[b] = (int*)realloc(queue->items[b], queue->capacities[b] * sizeof(int));
+        if (!queue->items[b]) {
+            perror("Erro ao realocar balde");
+            exit(EXIT_FAILURE);
+        }
+    }
+    queue->items[b][queue->sizes[b]++] = cell;
+    queue->count++;
+}
+
+// Remove uma célula de menor chave; *key recebe a chave
+int bucket_pop_min(BucketQueue* queue, int* key) {
+    while (queue->sizes[queue->cursor % queue->num_buckets] == 0) {
+        queue->cursor++;
+    }
+    int b = queue->cursor % queue->num_buckets;
+    queue->count--;
+    *key = queue->cursor;
+    return queue->items[b][--queue->sizes[b]];
+}
+
+// Libera a memória da fila de baldes
+void free_bucket_queue(BucketQueue* queue) {
+    if (!queue) return;
+    for (int b = 0; b < queue->num_buckets; b++) {
+        free(queue->items[b]);
+    }
+    free(queue->sizes);
+    free(queue->capacities);
+    free(queue->items);
+    free(queue);
+}
+
+// --- Vizinhanças de 4, 8 e 6 Células (Núcleos Especializados) ---
+
+// Estado compartilhado pelos núcleos de busca por vizinhança
+typedef struct GridSearch {
+    const PackedMaze* maze;
+    int num_rows;
+    int num_cols;
+    Cell end;
+    int h_factor;      // Menor custo do terreno no A*, 0 no Dijkstra
+    int* cost_so_far;  // Custo em décimos de passo (-1 se não alcançada)
+    bool* closed;
+    int* parent;
+    BucketQueue* queue;
+} GridSearch;
+
+// Heurísticas em décimos de passo, admissíveis para os custos 10 (reto) e 14 (diagonal)
+static inline int manhattan_heuristic(int r, int c, Cell end) {
+    return 10 * (abs(r - end.row) + abs(c - end.col));
+}
+
+static inline int octile_heuristic(int r, int c, Cell end) {
+    int dr = abs(r - end.row), dc = abs(c - end.col);
+    return dr > dc ? 10 * dr + 4 * dc : 10 * dc + 4 * dr;
+}
+
+// Distância hexagonal: coordenadas "odd-r" convertidas para cúbicas
+static inline int hex_heuristic(int r, int c, Cell end) {
+    int x1 = c - (r - (r & 1)) / 2, x2 = end.col - (end.row - (end.row & 1)) / 2;
+    int dx = abs(x1 - x2), dz = abs(r - end.row), dy = abs((x1 + r) - (x2 + end.row));
+    int d = dx > dy ? dx : dy;
+    return 10 * (d > dz ? d : dz);
+}
+
+// Relaxa a aresta u -> (r, c) com custo base 'step' vezes o custo do terreno de destino
+static inline void grid_relax(GridSearch* s, int u, int r, int c, int step, int (*heuristic)(int, int, Cell)) {
+    int v = map_coord_to_index(r, c, s->num_cols);
+    if (s->closed[v]) return;
+    int candidate = s->cost_so_far[u] + step * packed_maze_cost(s->maze, r, c);
+    if (s->cost_so_far[v] == -1 || candidate < s->cost_so_far[v]) {
+        s->cost_so_far[v] = candidate;
+        s->parent[v] = u;
+        bucket_push(s->queue, v, candidate + s->h_factor * heuristic(r, c, s->end));
+    }
+}
+
+// Vizinho aberto e dentro da grade (vizinhança hexagonal)
+static inline bool grid_open(const GridSearch* s, int r, int c) {
+    return is_valid(r, c, s->num_rows, s->num_cols) && !bitmap_is_wall(s->maze->walls, r, c);
+}
+
+// Vizinhos de cada modo, desenrolados. Bits de packed_open_neighbors: 1 cima, 2 baixo, 4 esquerda, 8 direita.
+#define EXPAND_4(S, U, R, C, OPEN)                                                    \
+    if ((OPEN) & 1) grid_relax(S, U, (R) - 1, C, 10, manhattan_heuristic);            \
+    if ((OPEN) & 2) grid_relax(S, U, (R) + 1, C, 10, manhattan_heuristic);            \
+    if ((OPEN) & 4) grid_relax(S, U, R, (C) - 1, 10, manhattan_heuristic);            \
+    if ((OPEN) & 8) grid_relax(S, U, R, (C) + 1, 10, manhattan_heuristic);
+
+// Diagonal só se as duas células ortogonais que ela atravessa estiverem abertas (sem cortar quinas)
+#define EXPAND_8(S, U, R, C, OPEN)                                                    \
+    if ((OPEN) & 1) grid_relax(S, U, (R) - 1, C, 10, octile_heuristic);               \
+    if ((OPEN) & 2) grid_relax(S, U, (R) + 1, C, 10, octile_heuristic);               \
+    if ((OPEN) & 4) grid_relax(S, U, R, (C) - 1, 10, octile_heuristic);               \
+    if ((OPEN) & 8) grid_relax(S, U, R, (C) + 1, 10, octile_heuristic);               \
+    if (((OPEN) & 5) == 5 && !bitmap_is_wall((S)->maze->walls, (R) - 1, (C) - 1))     \
+        grid_relax(S, U, (R) - 1, (C) - 1, 14, octile_heuristic);                     \
+    if (((OPEN) & 9) == 9 && !bitmap_is_wall((S)->maze->walls, (R) - 1, (C) + 1))     \
+        grid_relax(S, U, (R) - 1, (C) + 1, 14, octile_heuristic);                     \
+    if (((OPEN) & 6) == 6 && !bitmap_is_wall((S)->maze->walls, (R) + 1, (C) - 1))     \
+        grid_relax(S, U, (R) + 1, (C) - 1, 14, octile_heuristic);                     \
+    if (((OPEN) & 10) == 10 && !bitmap_is_wall((S)->maze->walls, (R) + 1, (C) + 1))   \
+        grid_relax(S, U, (R) + 1, (C) + 1, 14, octile_heuristic);
+
+// Hexágonos "odd-r": linhas ímpares deslocadas meia célula para a direita
+#define EXPAND_HEX(S, U, R, C, OPEN)                                                  \
+    if ((OPEN) & 4) grid_relax(S, U, R, (C) - 1, 10, hex_heuristic);                  \
+    if ((OPEN) & 8) grid_relax(S, U, R, (C) + 1, 10, hex_heuristic);                  \
+    {                                                                                 \
+        int shift = (R) & 1; /* Coluna da diagonal direita em cima e embaixo */      \
+        if (grid_open(S, (R) - 1, (C) - 1 + shift)) grid_relax(S, U, (R) - 1, (C) - 1 + shift, 10, hex_heuristic); \
+        if (grid_open(S, (R) - 1, (C) + shift)) grid_relax(S, U, (R) - 1, (C) + shift, 10, hex_heuristic);         \
+        if (grid_open(S, (R) + 1, (C) - 1 + shift)) grid_relax(S, U, (R) + 1, (C) - 1 + shift, 10, hex_heuristic); \
+        if (grid_open(S, (R) + 1, (C) + shift)) grid_relax(S, U, (R) + 1, (C) + shift, 10, hex_heuristic);         \
+    }
+
+// Gera um núcleo de busca com a lista de vizinhos EXPAND embutida no laço
+#define DEFINE_NEIGHBORHOOD_KERNEL(NAME, EXPAND)                                      \
+    static int NAME(GridSearch* s, int target) {                                      \
+        int pops = 0;                                                                 \
+        while (s->queue->count > 0) {                                                 \
+            int key;                                                                  \
+            int u = bucket_pop_min(s->queue, &key);                                   \
+            if (s->closed[u]) continue; /* Entrada obsoleta */                        \
+            s->closed[u] = true;                                                      \
+            pops++;                                                                   \
+            if (u == target) break;                                                   \
+            Cell cell;                                                                \
+            map_index_to_coord(u, s->num_cols, &cell);                                \
+            unsigned int open = packed_open_neighbors(s->maze, cell.row, cell.col);   \
+            EXPAND(s, u, cell.row, cell.col, open)                                    \
+        }                                                                             \
+        return pops;                                                                  \
+    }
+
+DEFINE_NEIGHBORHOOD_KERNEL(search_kernel_4, EXPAND_4)
+DEFINE_NEIGHBORHOOD_KERNEL(search_kernel_8, EXPAND_8)
+DEFINE_NEIGHBORHOOD_KERNEL(search_kernel_hex, EXPAND_HEX)
+
+// Converte o nome de uma vizinhança ("4", "8" ou "hex"); -1 se desconhecida
+int parse_neighborhood(const char* name) {
+    if (strcmp(name, "4") == 0) return NEIGHBORHOOD_4;
+    if (strcmp(name, "8") == 0) return NEIGHBORHOOD_8;
+    if (strcmp(name, "hex") == 0) return NEIGHBORHOOD_HEX;
+    return -1;
+}
+
+/**
+ * @brief Dijkstra ou A* sobre o terreno com a vizinhança escolhida.
+ *
+ * Custos em décimos de passo: 10 por passo reto e 14 por diagonal (octil),
+ * multiplicados pelo custo do terreno de destino. Na vizinhança de 8, uma
+ * diagonal só é permitida se as duas células ortogonais adjacentes estiverem
+ * abertas. A heurística do A* (Manhattan, octil ou hexagonal) é multiplicada
+ * pelo menor custo do terreno. Cada vizinhança tem seu próprio núcleo, gerado
+ * por macro, com os vizinhos desenrolados no laço principal.
+ *
+ * @param maze O labirinto compacto.
+ * @param neighborhood NEIGHBORHOOD_4, NEIGHBORHOOD_8 ou NEIGHBORHOOD_HEX.
+ * @param start A célula de partida.
+ * @param end A célula de chegada.
+ * @param use_heuristic false para Dijkstra, true para A*.
+ * @param parent Saída com layout_num_cells posições: predecessores (para print_path).
+ * @param expanded Saída opcional (NULL): número de células retiradas da fila.
+ * @return O custo do caminho em décimos de passo, ou -1 se end for inalcançável.
+ */
+int neighborhood_search(const PackedMaze* maze, Neighborhood neighborhood, Cell start, Cell end, bool use_heuristic,
+                        int parent[], int* expanded) {
+    GridSearch s;
+    s.maze = maze;
+    s.num_rows = maze->walls->num_rows;
+    s.num_cols = maze->walls->num_cols;
+    s.end = end;
+    int num_cells = layout_num_cells(s.num_rows, s.num_cols);
+    s.cost_so_far = (int*)malloc((size_t)num_cells * sizeof(int));
+    s.closed = (bool*)calloc((size_t)num_cells, sizeof(bool));
+    if (!s.cost_so_far || !s.closed) {
+        perror("Erro ao alocar busca por vizinhança");
+        exit(EXIT_FAILURE);
+    }
+    s.parent = parent;
+    for (int i = 0; i < num_cells; i++) {
+        s.cost_so_far[i] = -1;
+        parent[i] = -1;
+    }
+
+    int min_cost = 1, max_cost = 1;
+    if (maze->cost) {
+        min_cost = 9;
+        for (int r = 0; r < s.num_rows; r++) {
+            for (int c = 0; c < s.num_cols; c++) {
+                if (bitmap_is_wall(maze->walls, r, c)) continue;
+                int cost = packed_maze_cost(maze, r, c);
+                if (cost < min_cost) min_cost = cost;
+                if (cost > max_cost) max_cost = cost;
+            }
+        }
+    }
+    s.h_factor = use_heuristic ? min_cost : 0;
+    // Um passo aumenta a chave em no máximo 14 * max_cost + 14 * h_factor
+    s.queue = create_bucket_queue(14 * (max_cost + s.h_factor) + 1);
+
+    int (*heuristic)(int, int, Cell) = neighborhood == NEIGHBORHOOD_8 ? octile_heuristic
+                                       : neighborhood == NEIGHBORHOOD_HEX ? hex_heuristic
+                                                                         : manhattan_heuristic;
+    int source = map_coord_to_index(start.row, start.col, s.num_cols);
+    int target = map_coord_to_index(end.row, end.col, s.num_cols);
+    s.cost_so_far[source] = 0;
+    bucket_push(s.queue, source, s.h_factor * heuristic(start.row, start.col, end));
+
+    int pops;
+    switch (neighborhood) {
+        case NEIGHBORHOOD_8: pops = search_kernel_8(&s, target); break;
+        case NEIGHBORHOOD_HEX: pops = search_kernel_hex(&s, target); break;
+        default: pops = search_kernel_4(&s, target); break;
+    }
+
+    int total = s.closed[target] ? s.cost_so_far[target] : -1;
+    if (expanded) *expanded = pops;
+    free_bucket_queue(s.queue);
+    free(s.cost_so_far);
+    free(s.closed);
+    return total;
+}
+
+// Modo "terreno": ./projeto1 terreno <labirinto.txt> [4|8|hex]
+// Rota de menor custo de S até E com Dijkstra e com A*, ambos com fila de baldes.
+// Na vizinhança de 4 (padrão) todo custo é múltiplo de 10 décimos e é mostrado
+// inteiro; nas demais, em décimos de passo.
+int terrain_command(int argc, char* argv[]) {
+    int neighborhood = argc >= 4 ? parse_neighborhood(argv[3]) : NEIGHBORHOOD_4;
+    if (argc < 3 || neighborhood < 0) {
+        fprintf(stderr, "Uso: %s terreno <labirinto.txt> [4|8|hex]\n", argv[0]);
+        return 1;
+    }
+    PackedMaze* maze = load_maze(argv[2]);
+    if (!maze) {
+        return 1;
+    }
+    int num_cols = maze->walls->num_cols;
+    int* parent = (int*)malloc((size_t)layout_num_cells(maze->walls->num_rows, num_cols) * sizeof(int));
+    if (!parent) {
+        perror("Erro ao alocar predecessores");
+        exit(EXIT_FAILURE);
+    }
+    const char* names[2] = {"Dijkstra", "A*"};
+    for (int k = 0; k < 2; k++) {
+        int expanded = 0;
+        clock_t begin = clock();
+        int total = neighborhood_search(maze, (Neighborhood)neighborhood, maze->start, maze->end, k == 1, parent,
+                                        &expanded);
+        double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+        printf("\n--- %s no Terreno (fila de baldes, vizinhança %s) ---\n", names[k], argc >= 4 ? argv[3] : "4");
+        if (total < 0) {
+            printf("Nenhum caminho encontrado por %s.\n", names[k]);
+            continue;
+        }
+        if (neighborhood == NEIGHBORHOOD_4) {
+            printf("Custo de S até E: %d (%d células expandidas em %.3f s).\n", total / 10, expanded, seconds);
+        } else {
+            printf("Custo de S até E: %d.%d (%d células expandidas em %.3f s).\n", total / 10, total % 10, expanded,
+                   seconds);
+        }
+        print_path(parent, map_coord_to_index(maze->start.row, maze->start.col, num_cols),
+                   map_coord_to_index(maze->end.row, maze->end.col, num_cols), num_cols,
+                   (Neighborhood)neighborhood);
+    }
+    free(parent);
+    free_packed_maze(maze);
+    return 0;
+}
+
+// --- Busca Hierárquica (HPA*) ---
+
+// Formato binário: "HPAG", linhas, colunas, tamanho do cluster, menor custo,
+// nós e arestas (int32), a impressão digital do labirinto (uint64), e então
+// node_cell[], edge_offset[], edge_target[] e edge_cost[] (int32).
+static const char HPA_GRAPH_MAGIC[4] = {'H', 'P', 'A', 'G'};
+
+// Lista de arestas crescente usada durante a construção do grafo abstrato
+typedef struct HpaEdgeList {
+    int size;
+    int capacity;
+    int* source;
+    int* target;
+    int* cost;
+} HpaEdgeList;
+
+static void hpa_edge_list_add(HpaEdgeList* list, int source, int target, int cost) {
+    if (list->size == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 256;
+        list->source = (int*)realloc(list->source, list->capacity * sizeof(int));
+        list->target = (int*)realloc(list->target, list->capacity * sizeof(int));
+        list->cost = (int*)realloc(list->cost, list->capacity * sizeof(int));
+        if (!list->source || !list->target || !list->cost) {
+            perror("Erro ao realocar arestas abstratas");
+            exit(EXIT_FAILURE);
+        }
+    }
+    list->source[list->size] = source;
+    list->target[list->size] = target;
+    list->cost[list->size] = cost;
+    list->size++;
+}
+
+// Impressão digital (FNV-1a) das paredes e custos, para reconhecer uma abstração velha
+uint64_t maze_fingerprint(const PackedMaze* maze) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (int r = 0; r < maze->walls->num_rows; r++) {
+        for (int c = 0; c < maze->walls->num_cols; c++) {
+            int value = bitmap_is_wall(maze->walls, r, c) ? 0 : packed_maze_cost(maze, r, c);
+            hash = (hash ^ (uint64_t)value) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+// Cluster que contém a célula (r, c)
+static inline int hpa_cluster_of(const HpaGraph* hpa, int r, int c) {
+    return (r / hpa->cluster_size) * hpa->clusters_per_row + c / hpa->cluster_size;
+}
+
+// Maior tamanho de cluster que faz sentido: acima do maior lado, todos são iguais
+static inline int hpa_max_cluster_size(int num_rows, int num_cols) {
+    return num_rows > num_cols ? num_rows : num_cols;
+}
+
+// Células do maior cluster (recortado pela grade), para os buffers locais
+static inline int hpa_cluster_area(const HpaGraph* hpa) {
+    int height = hpa->cluster_size < hpa->num_rows ? hpa->cluster_size : hpa->num_rows;
+    int width = hpa->cluster_size < hpa->num_cols ? hpa->cluster_size : hpa->num_cols;
+    return height * width;
+}
+
+/**
+ * @brief Dijkstra restrito a um cluster, em índices locais (r - r0) * largura + (c - c0).
+ *
+ * Com reverse, a busca percorre as arestas ao contrário (o passo custa o terreno
+ * da célula de onde se sai), e dist[] passa a ser o custo de cada célula até source.
+ *
+ * @param heap Heap com capacidade para as células do cluster (vazio).
+ * @param dist Saída: custo local (-1 se inalcançável dentro do cluster).
+ * @param parent Saída: predecessor local (-1 na origem).
+ */
+static void cluster_dijkstra(const PackedMaze* maze, const HpaGraph* hpa, MinHeap* heap, Cell source, bool reverse,
+                             int dist[], int parent[]) {
+    int k = hpa->cluster_size;
+    int r0 = source.row / k * k, c0 = source.col / k * k;
+    int r1 = r0 + k < hpa->num_rows ? r0 + k : hpa->num_rows;
+    int c1 = c0 + k < hpa->num_cols ? c0 + k : hpa->num_cols;
+    int width = c1 - c0;
+    for (int i = 0; i < (r1 - r0) * width; i++) {
+        dist[i] = -1;
+        parent[i] = -1;
+    }
+    int s = (source.row - r0) * width + (source.col - c0);
+    dist[s] = 0;
+    heap_push_or_decrease(heap, s, 0);
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        int r = r0 + u / width, c = c0 + u % width;
+        unsigned int open = packed_open_neighbors(maze, r, c);
+        static const int dr[4] = {-1, 1, 0, 0};
+        static const int dc[4] = {0, 0, -1, 1};
+        for (int i = 0; i < 4; i++) {
+            int nr = r + dr[i], nc = c + dc[i];
+            if (!(open & (1u << i)) || nr < r0 || nr >= r1 || nc < c0 || nc >= c1) continue;
+            int v = (nr - r0) * width + (nc - c0);
+            int candidate = dist[u] + (reverse ? packed_maze_cost(maze, r, c) : packed_maze_cost(maze, nr, nc));
+            if (dist[v] == -1 || candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                heap_push_or_decrease(heap, v, candidate);
+            }
+        }
+    }
+}
+
+// Aloca um grafo abstrato vazio com os campos de cabeçalho já preenchidos
+static HpaGraph* create_hpa_graph(int num_rows, int num_cols, int cluster_size) {
+    HpaGraph* hpa = (HpaGraph*)calloc(1, sizeof(HpaGraph));
+    if (!hpa) {
+        perror("Erro ao alocar grafo abstrato");
+        exit(EXIT_FAILURE);
+    }
+    hpa->num_rows = num_rows;
+    hpa->num_cols = num_cols;
+    hpa->cluster_size = cluster_size;
+    hpa->clusters_per_row = (num_cols + cluster_size - 1) / cluster_size;
+    return hpa;
+}
+
+// Libera a memória do grafo abstrato
+void free_hpa_graph(HpaGraph* hpa) {
+    if (!hpa) return;
+    free(hpa->node_cell);
+    free(hpa->edge_offset);
+    free(hpa->edge_target);
+    free(hpa->edge_cost);
+    free(hpa);
+}
+
+/**
+ * @brief Constrói o grafo abstrato do HPA*.
+ *
+ * A grade é dividida em clusters cluster_size x cluster_size. Em cada borda
+ * entre dois clusters, cada trecho contínuo de pares de células abertas (uma de
+ * cada lado) é uma entrada, com uma transição no meio do trecho: duas células
+ * vizinhas ligadas por uma aresta entre clusters. Dentro de cada cluster, um
+ * Dijkstra local a partir de cada transição dá as arestas internas com o custo
+ * exato entre as transições do mesmo cluster.
+ *
+ * @param maze O labirinto compacto (com ou sem custos).
+ * @param cluster_size Lado dos clusters, em células (limitado ao maior lado da grade).
+ * @return O grafo abstrato, em listas de arestas contíguas (CSR).
+ */
+HpaGraph* build_hpa_graph(const PackedMaze* maze, int cluster_size) {
+    int num_rows = maze->walls->num_rows;
+    int num_cols = maze->walls->num_cols;
+    if (cluster_size > hpa_max_cluster_size(num_rows, num_cols)) {
+        cluster_size = hpa_max_cluster_size(num_rows, num_cols);
+    }
+    HpaGraph* hpa = create_hpa_graph(num_rows, num_cols, cluster_size);
+    hpa->fingerprint = maze_fingerprint(maze);
+    hpa->min_cost = 9;
+    for (int r = 0; r < num_rows; r++) {
+        for (int c = 0; c < num_cols; c++) {
+            if (!bitmap_is_wall(maze->walls, r, c) && packed_maze_cost(maze, r, c) < hpa->min_cost) {
+                hpa->min_cost = packed_maze_cost(maze, r, c);
+            }
+        }
+    }
+
+    // Transições: um nó por célula de borda escolhida (node_of evita duplicatas)
+    int* node_of = (int*)malloc((size_t)num_rows * num_cols * sizeof(int));
+    if (!node_of) {
+        perror("Erro ao alocar transições");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_rows * num_cols; i++) {
+        node_of[i] = -1;
+    }
+    int node_capacity = 0;
+    HpaEdgeList edges = {0, 0, NULL, NULL, NULL};
+    for (int vertical = 0; vertical < 2; vertical++) {
+        // vertical = 0: bordas entre linhas de clusters; 1: entre colunas de clusters
+        int limit = vertical ? num_cols : num_rows;
+        int along = vertical ? num_rows : num_cols;
+        for (int border = cluster_size; border < limit; border += cluster_size) {
+            for (int block = 0; block < along; block += cluster_size) {
+                int block_end = block + cluster_size < along ? block + cluster_size : along;
+                int run_start = -1;
+                for (int i = block; i <= block_end; i++) {
+                    bool open = false;
+                    if (i < block_end) {
+                        open = vertical ? !bitmap_is_wall(maze->walls, i, border - 1) && !bitmap_is_wall(maze->walls, i, border)
+                                        : !bitmap_is_wall(maze->walls, border - 1, i) && !bitmap_is_wall(maze->walls, border, i);
+                    }
+                    if (open && run_start < 0) {
+                        run_start = i;
+                    } else if (!open && run_start >= 0) {
+                        int middle = (run_start + i - 1) / 2; // Uma transição no meio da entrada
+                        int a = vertical ? middle * num_cols + border - 1 : (border - 1) * num_cols + middle;
+                        int b = vertical ? middle * num_cols + border : border * num_cols + middle;
+                        for (int side = 0; side < 2; side++) {
+                            int cell = side ? b : a;
+                            if (node_of[cell] >= 0) continue;
+                            if (hpa->num_nodes == node_capacity) {
+                                node_capacity = node_capacity ? node_capacity * 2 : 256;
+                                hpa->node_cell = (int*)realloc(hpa->node_cell, node_capacity * sizeof(int));
+                                if (!hpa->node_cell) {
+                                    perror("Erro ao realocar transições");
+                                    exit(EXIT_FAILURE);
+                                }
+                            }
+                            node_of[cell] = hpa->num_nodes;
+                            hpa->node_cell[hpa->num_nodes++] = cell;
+                        }
+                        // Aresta entre clusters: o passo custa o terreno da célula de chegada
+                        hpa_edge_list_add(&edges, node_of[a], node_of[b], packed_maze_cost(maze, b / num_cols, b % num_cols));
+                        hpa_edge_list_add(&edges, node_of[b], node_of[a], packed_maze_cost(maze, a / num_cols, a % num_cols));
+                        run_start = -1;
+                    }
+                }
+            }
+        }
+    }
+    free(node_of);
+
+    // Agrupa as transições por cluster (ordenação por contagem)
+    int num_clusters = ((num_rows + cluster_size - 1) / cluster_size) * hpa->clusters_per_row;
+    int* cluster_start = (int*)calloc(num_clusters + 1, sizeof(int));
+    int* by_cluster = (int*)malloc((hpa->num_nodes > 0 ? hpa->num_nodes : 1) * sizeof(int));
+    int* local_dist = (int*)malloc(hpa_cluster_area(hpa) * sizeof(int));
+    int* local_parent = (int*)malloc(hpa_cluster_area(hpa) * sizeof(int));
+    if (!cluster_start || !by_cluster || !local_dist || !local_parent) {
+        perror("Erro ao alocar clusters");
+        exit(EXIT_FAILURE);
+    }
+    for (int n = 0; n < hpa->num_nodes; n++) {
+        cluster_start[hpa_cluster_of(hpa, hpa->node_cell[n] / num_cols, hpa->node_cell[n] % num_cols) + 1]++;
+    }
+    for (int k = 0; k < num_clusters; k++) {
+        cluster_start[k + 1] += cluster_start[k];
+    }
+    for (int n = 0; n < hpa->num_nodes; n++) {
+        int k = hpa_cluster_of(hpa, hpa->node_cell[n] / num_cols, hpa->node_cell[n] % num_cols);
+        by_cluster[cluster_start[k]++] = n;
+    }
+    for (int k = num_clusters; k > 0; k--) {
+        cluster_start[k] = cluster_start[k - 1];
+    }
+    cluster_start[0] = 0;
+
+    // Arestas internas: custo exato entre cada par de transições do mesmo cluster
+    MinHeap* heap = create_min_heap(hpa_cluster_area(hpa));
+    for (int k = 0; k < num_clusters; k++) {
+        for (int i = cluster_start[k]; i < cluster_start[k + 1]; i++) {
+            int from = by_cluster[i];
+            Cell source = {hpa->node_cell[from] / num_cols, hpa->node_cell[from] % num_cols};
+            cluster_dijkstra(maze, hpa, heap, source, false, local_dist, local_parent);
+            int r0 = source.row / cluster_size * cluster_size, c0 = source.col / cluster_size * cluster_size;
+            int width = (c0 + cluster_size < num_cols ? c0 + cluster_size : num_cols) - c0;
+            for (int j = cluster_start[k]; j < cluster_start[k + 1]; j++) {
+                int to = by_cluster[j];
+                int cell = hpa->node_cell[to];
+                int d = local_dist[(cell / num_cols - r0) * width + (cell % num_cols - c0)];
+                if (to != from && d >= 0) {
+                    hpa_edge_list_add(&edges, from, to, d);
+                }
+            }
+        }
+    }
+    free_min_heap(heap);
+    free(cluster_start);
+    free(by_cluster);
+    free(local_dist);
+    free(local_parent);
+
+    // Lista de arestas -> CSR por nó de origem
+    hpa->num_edges = edges.size;
+    hpa->edge_offset = (int*)calloc(hpa->num_nodes + 1, sizeof(int));
+    hpa->edge_target = (int*)malloc((edges.size > 0 ? edges.size : 1) * sizeof(int));
+    hpa->edge_cost = (int*)malloc((edges.size > 0 ? edges.size : 1) * sizeof(int));
+    if (!hpa->edge_offset || !hpa->edge_target || !hpa->edge_cost) {
+        perror("Erro ao alocar arestas abstratas");
+        exit(EXIT_FAILURE);
+    }
+    for (int e = 0; e < edges.size; e++) {
+        hpa->edge_offset[edges.source[e] + 1]++;
+    }
+    for (int n = 0; n < hpa->num_nodes; n++) {
+        hpa->edge_offset[n + 1] += hpa->edge_offset[n];
+    }
+    for (int e = 0; e < edges.size; e++) {
+        int slot = hpa->edge_offset[edges.source[e]]++;
+        hpa->edge_target[slot] = edges.target[e];
+        hpa->edge_cost[slot] = edges.cost[e];
+    }
+    for (int n = hpa->num_nodes; n > 0; n--) {
+        hpa->edge_offset[n] = hpa->edge_offset[n - 1];
+    }
+    hpa->edge_offset[0] = 0;
+    free(edges.source);
+    free(edges.target);
+    free(edges.cost);
+    return hpa;
+}
+
+// Grava o grafo abstrato; retorna 0 em caso de sucesso, -1 em erro
+int save_hpa_graph(const HpaGraph* hpa, const char* filename) {
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        perror("Erro ao criar arquivo da abstração");
+        return -1;
+    }
+    int32_t header[6] = {hpa->num_rows, hpa->num_cols, hpa->cluster_size, hpa->min_cost, hpa->num_nodes, hpa->num_edges};
+    bool ok = fwrite(HPA_GRAPH_MAGIC, 1, 4, file) == 4 && fwrite(header, sizeof(int32_t), 6, file) == 6 &&
+              fwrite(&hpa->fingerprint, sizeof(uint64_t), 1, file) == 1;
+    const int* arrays[4] = {hpa->node_cell, hpa->edge_offset, hpa->edge_target, hpa->edge_cost};
+    int counts[4] = {hpa->num_nodes, hpa->num_nodes + 1, hpa->num_edges, hpa->num_edges};
+    for (int a = 0; a < 4 && ok; a++) {
+        for (int i = 0; i < counts[a] && ok; i++) {
+            int32_t value = arrays[a][i];
+            ok = fwrite(&value, sizeof(int32_t), 1, file) == 1;
+        }
+    }
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "Erro ao gravar '%s'.\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// Carrega um grafo gravado por save_hpa_graph; retorna NULL em erro
+HpaGraph* load_hpa_graph(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        return NULL; // Ausência do arquivo é normal: a abstração será construída
+    }
+    char magic[4];
+    int32_t header[6];
+    uint64_t fingerprint;
+    if (fread(magic, 1, 4, file) != 4 || memcmp(magic, HPA_GRAPH_MAGIC, 4) != 0 ||
+        fread(header, sizeof(int32_t), 6, file) != 6 || fread(&fingerprint, sizeof(uint64_t), 1, file) != 1 ||
+        header[0] <= 0 || header[1] <= 0 || header[2] <= 0 ||
+        header[2] > hpa_max_cluster_size(header[0], header[1]) || header[3] < 1 || header[3] > 9 || header[4] < 0 ||
+        header[5] < 0) {
+        fprintf(stderr, "Arquivo '%s' não é uma abstração HPA* válida.\n", filename);
+        fclose(file);
+        return NULL;
+    }
+    HpaGraph* hpa = create_hpa_graph(header[0], header[1], header[2]);
+    hpa->min_cost = header[3];
+    hpa->num_nodes = header[4];
+    hpa->num_edges = header[5];
+    hpa->fingerprint = fingerprint;
+    hpa->node_cell = (int*)malloc((hpa->num_nodes > 0 ? hpa->num_nodes : 1) * sizeof(int));
+    hpa->edge_offset = (int*)malloc((hpa->num_nodes + 1) * sizeof(int));
+    hpa->edge_target = (int*)malloc((hpa->num_edges > 0 ? hpa->num_edges : 1) * sizeof(int));
+    hpa->edge_cost = (int*)malloc((hpa->num_edges > 0 ? hpa->num_edges : 1) * sizeof(int));
+    if (!hpa->node_cell || !hpa->edge_offset || !hpa->edge_target || !hpa->edge_cost) {
+        perror("Erro ao alocar grafo abstrato");
+        exit(EXIT_FAILURE);
+    }
+    int* arrays[4] = {hpa->node_cell, hpa->edge_offset, hpa->edge_target, hpa->edge_cost};
+    int counts[4] = {hpa->num_nodes, hpa->num_nodes + 1, hpa->num_edges, hpa->num_edges};
+    int64_t num_cells = (int64_t)hpa->num_rows * hpa->num_cols;
+    bool ok = true;
+    for (int a = 0; a < 4 && ok; a++) {
+        for (int i = 0; i < counts[a] && ok; i++) {
+            int32_t value;
+            ok = fread(&value, sizeof(int32_t), 1, file) == 1;
+            arrays[a][i] = value;
+            // Cada índice precisa caber no que ele indexa
+            if (a == 0) ok = ok && value >= 0 && value < num_cells;
+            if (a == 1) ok = ok && value >= (i > 0 ? arrays[1][i - 1] : 0) && value <= hpa->num_edges;
+            if (a == 2) ok = ok && value >= 0 && value < hpa->num_nodes;
+            if (a == 3) ok = ok && value >= 0;
+        }
+    }
+    ok = ok && hpa->edge_offset[0] == 0 && hpa->edge_offset[hpa->num_nodes] == hpa->num_edges;
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Arquivo '%s' truncado ou inválido.\n", filename);
+        free_hpa_graph(hpa);
+        return NULL;
+    }
+    return hpa;
+}
+
+// Verifica se a abstração foi construída para este labirinto (dimensões e impressão digital)
+bool hpa_graph_matches(const HpaGraph* hpa, const PackedMaze* maze) {
+    return hpa->num_rows == maze->walls->num_rows && hpa->num_cols == maze->walls->num_cols &&
+           hpa->fingerprint == maze_fingerprint(maze);
+}
+
+// Acrescenta ao caminho o trecho local de 'from' até 'to' (mesmo cluster), sem repetir 'from'
+static void hpa_refine_segment(const PackedMaze* maze, const HpaGraph* hpa, MinHeap* heap, int local_dist[],
+                               int local_parent[], Cell from, Cell to, int** path, int* path_len, int* capacity) {
+    cluster_dijkstra(maze, hpa, heap, from, false, local_dist, local_parent);
+    int k = hpa->cluster_size;
+    int r0 = from.row / k * k, c0 = from.col / k * k;
+    int width = (c0 + k < hpa->num_cols ? c0 + k : hpa->num_cols) - c0;
+    int target = (to.row - r0) * width + (to.col - c0);
+    int steps = 0;
+    for (int v = target; local_parent[v] != -1; v = local_parent[v]) {
+        steps++;
+    }
+    if (*path_len + steps > *capacity) {
+        *capacity = (*path_len + steps) * 2;
+        *path = (int*)realloc(*path, *capacity * sizeof(int));
+        if (!*path) {
+            perror("Erro ao realocar caminho");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int i = *path_len + steps - 1;
+    for (int v = target; local_parent[v] != -1; v = local_parent[v]) {
+        (*path)[i--] = map_coord_to_index(r0 + v / width, c0 + v % width, hpa->num_cols);
+    }
+    *path_len += steps;
+}
+
+/**
+ * @brief Consulta HPA*: liga S e E às transições dos seus clusters, busca no
+ *        grafo abstrato (A*) e refina cada aresta com Dijkstra local.
+ *
+ * O resultado é quase ótimo: a busca só cruza bordas pelas transições. Se S
+ * e E estão no mesmo cluster, o caminho local direto também é considerado.
+ *
+ * @param maze O labirinto compacto usado na construção da abstração.
+ * @param hpa O grafo abstrato.
+ * @param start A célula de partida.
+ * @param end A célula de chegada.
+ * @param path Saída opcional (NULL): caminho alocado com malloc, em índices de map_coord_to_index.
+ * @param path_len Saída opcional (NULL): número de células do caminho.
+ * @return O custo do caminho, ou -1 se não houver caminho pela abstração.
+ */
+int hpa_search(const PackedMaze* maze, const HpaGraph* hpa, Cell start, Cell end, int** path, int* path_len) {
+    int num_cols = hpa->num_cols;
+    int k = hpa->cluster_size;
+    int n = hpa->num_nodes;
+    int start_id = n, end_id = n + 1; // Nós temporários de S e E
+    int* local_dist = (int*)malloc(hpa_cluster_area(hpa) * sizeof(int));
+    int* local_parent = (int*)malloc(hpa_cluster_area(hpa) * sizeof(int));
+    int* to_end = (int*)malloc((n + 2) * sizeof(int));   // Custo de cada nó até E (mesmo cluster)
+    int* from_start = (int*)malloc((n + 2) * sizeof(int)); // Custo de S até cada nó (mesmo cluster)
+    int* dist = (int*)malloc((n + 2) * sizeof(int));
+    int* parent = (int*)malloc((n + 2) * sizeof(int));
+    bool* closed = (bool*)calloc(n + 2, sizeof(bool));
+    if (!local_dist || !local_parent || !to_end || !from_start || !dist || !parent || !closed) {
+        perror("Erro ao alocar consulta HPA*");
+        exit(EXIT_FAILURE);
+    }
+    MinHeap* local_heap = create_min_heap(hpa_cluster_area(hpa));
+    int start_cluster = hpa_cluster_of(hpa, start.row, start.col);
+    int end_cluster = hpa_cluster_of(hpa, end.row, end.col);
+    int r0 = start.row / k * k, c0 = start.col / k * k;
+    int width = (c0 + k < num_cols ? c0 + k : num_cols) - c0;
+    int direct = -1;
+
+    // Liga S às transições do seu cluster e, ao contrário, as transições de E a E
+    for (int i = 0; i < n + 2; i++) {
+        from_start[i] = to_end[i] = -1;
+    }
+    cluster_dijkstra(maze, hpa, local_heap, start, false, local_dist, local_parent);
+    for (int i = 0; i < n; i++) {
+        int cell = hpa->node_cell[i];
+        if (hpa_cluster_of(hpa, cell / num_cols, cell % num_cols) == start_cluster) {
+            from_start[i] = local_dist[(cell / num_cols - r0) * width + (cell % num_cols - c0)];
+        }
+    }
+    if (start_cluster == end_cluster) {
+        direct = local_dist[(end.row - r0) * width + (end.col - c0)];
+    }
+    cluster_dijkstra(maze, hpa, local_heap, end, true, local_dist, local_parent);
+    r0 = end.row / k * k;
+    c0 = end.col / k * k;
+    width = (c0 + k < num_cols ? c0 + k : num_cols) - c0;
+    for (int i = 0; i < n; i++) {
+        int cell = hpa->node_cell[i];
+        if (hpa_cluster_of(hpa, cell / num_cols, cell % num_cols) == end_cluster) {
+            to_end[i] = local_dist[(cell / num_cols - r0) * width + (cell % num_cols - c0)];
+        }
+    }
+
+    // A* no grafo abstrato: heurística de Manhattan vezes o menor custo do terreno
+    for (int i = 0; i < n + 2; i++) {
+        dist[i] = -1;
+        parent[i] = -1;
+    }
+    MinHeap* heap = create_min_heap(n + 2);
+    dist[start_id] = 0;
+    heap_push_or_decrease(heap, start_id, 0);
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        closed[u] = true;
+        if (u == end_id) break;
+        int count = u == start_id ? n : hpa->edge_offset[u + 1] - hpa->edge_offset[u];
+        for (int i = 0; i <= count; i++) {
+            int v, cost;
+            if (i == count) {
+                v = end_id; // Última "aresta": a ligação até E, se existir
+                cost = u == start_id ? direct : to_end[u];
+            } else if (u == start_id) {
+                v = i;
+                cost = from_start[i];
+            } else {
+                v = hpa->edge_target[hpa->edge_offset[u] + i];
+                cost = hpa->edge_cost[hpa->edge_offset[u] + i];
+            }
+            if (cost < 0 || closed[v]) continue;
+            int candidate = dist[u] + cost;
+            if (dist[v] == -1 || candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                int cell = v == end_id ? end.row * num_cols + end.col : hpa->node_cell[v];
+                int h = hpa->min_cost * (abs(cell / num_cols - end.row) + abs(cell % num_cols - end.col));
+                heap_push_or_decrease(heap, v, candidate + h);
+            }
+        }
+    }
+    free_min_heap(heap);
+
+    int total = dist[end_id];
+    if (total >= 0 && (path || path_len)) {
+        // Refinamento: cada aresta abstrata vira o trecho local correspondente
+        int capacity = 64, length = 1;
+        int* cells = (int*)malloc(capacity * sizeof(int));
+        int* abstract_path = (int*)malloc((n + 2) * sizeof(int));
+        if (!cells || !abstract_path) {
+            perror("Erro ao alocar caminho");
+            exit(EXIT_FAILURE);
+        }
+        int hops = 0;
+        for (int v = end_id; v != -1; v = parent[v]) {
+            abstract_path[hops++] = v;
+        }
+        cells[0] = map_coord_to_index(start.row, start.col, num_cols);
+        Cell previous = start;
+        for (int i = hops - 2; i >= 0; i--) {
+            int v = abstract_path[i];
+            Cell next = v == end_id ? end : (Cell){hpa->node_cell[v] / num_cols, hpa->node_cell[v] % num_cols};
+            if (hpa_cluster_of(hpa, previous.row, previous.col) == hpa_cluster_of(hpa, next.row, next.col)) {
+                hpa_refine_segment(maze, hpa, local_heap, local_dist, local_parent, previous, next, &cells, &length,
+                                   &capacity);
+            } else {
+                // Aresta entre clusters: as duas células são vizinhas
+                if (length == capacity) {
+                    capacity *= 2;
+                    cells = (int*)realloc(cells, capacity * sizeof(int));
+                    if (!cells) {
+                        perror("Erro ao realocar caminho");
+                        exit(EXIT_FAILURE);
+                    }
+                }
+                cells[length++] = map_coord_to_index(next.row, next.col, num_cols);
+            }
+            previous = next;
+        }
+        free(abstract_path);
+        if (path_len) *path_len = length;
+        if (path) *path = cells;
+        else free(cells);
+    }
+
+    free_min_heap(local_heap);
+    free(local_dist);
+    free(local_parent);
+    free(to_end);
+    free(from_start);
+    free(dist);
+    free(parent);
+    free(closed);
+    return total;
+}
+
+// Modo "hpa": ./projeto1 hpa <labirinto.txt> <abstracao.bin> [tamanho_do_cluster]
+// Reaproveita a abstração gravada se ela corresponder ao labirinto; senão a
+// constrói e grava. Depois resolve S -> E e compara com o custo exato.
+int hpa_command(int argc, char* argv[]) {
+    int cluster_size = argc >= 5 ? atoi(argv[4]) : 16;
+    if (argc < 4 || cluster_size < 2) {
+        fprintf(stderr, "Uso: %s hpa <labirinto.txt> <abstracao.bin> [tamanho_do_cluster]\n", argv[0]);
+        return 1;
+    }
+    PackedMaze* maze = load_maze(argv[2]);
+    if (!maze) {
+        return 1;
+    }
+    if (cluster_size > hpa_max_cluster_size(maze->walls->num_rows, maze->walls->num_cols)) {
+        cluster_size = hpa_max_cluster_size(maze->walls->num_rows, maze->walls->num_cols);
+    }
+
+    clock_t begin = clock();
+    HpaGraph* hpa = load_hpa_graph(argv[3]);
+    if (hpa && (!hpa_graph_matches(hpa, maze) || (argc >= 5 && hpa->cluster_size != cluster_size))) {
+        printf("Abstração em '%s' é de outro labirinto ou tamanho de cluster; reconstruindo.\n", argv[3]);
+        free_hpa_graph(hpa);
+        hpa = NULL;
+    }
+    if (hpa) {
+        printf("Abstração carregada de '%s'", argv[3]);
+    } else {
+        hpa = build_hpa_graph(maze, cluster_size);
+        if (save_hpa_graph(hpa, argv[3]) != 0) {
+            free_hpa_graph(hpa);
+            free_packed_maze(maze);
+            return 1;
+        }
+        printf("Abstração construída e gravada em '%s'", argv[3]);
+    }
+    printf(" em %.3f s: clusters %dx%d, %d transições, %d arestas.\n", (double)(clock() - begin) / CLOCKS_PER_SEC,
+           hpa->cluster_size, hpa->cluster_size, hpa->num_nodes, hpa->num_edges);
+
+    int* path = NULL;
+    int path_len = 0;
+    begin = clock();
+    int total = hpa_search(maze, hpa, maze->start, maze->end, &path, &path_len);
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    printf("\n--- Busca Hierárquica (HPA*) ---\n");
+    if (total < 0) {
+        printf("Nenhum caminho encontrado pelo HPA*.\n");
+    } else {
+        int* parent = (int*)malloc((size_t)layout_num_cells(maze->walls->num_rows, maze->walls->num_cols) * sizeof(int));
+        if (!parent) {
+            perror("Erro ao alocar predecessores");
+            exit(EXIT_FAILURE);
+        }
+        int exact = neighborhood_search(maze, NEIGHBORHOOD_4, maze->start, maze->end, false, parent, NULL) / 10;
+        printf("Custo de S até E: %d em %.3f s (ótimo: %d; %d células no caminho).\n", total, seconds, exact, path_len);
+        size_t length = encode_path_rle(path, path_len, maze->walls->num_cols, NEIGHBORHOOD_4, NULL, 0);
+        char* directions = (char*)malloc(length + 1);
+        if (!directions) {
+            perror("Erro ao alocar direções");
+            exit(EXIT_FAILURE);
+        }
+        encode_path_rle(path, path_len, maze->walls->num_cols, NEIGHBORHOOD_4, directions, length + 1);
+        printf("Direções: %s\n", directions);
+        free(directions);
+        free(parent);
+    }
+    free(path);
+    free_hpa_graph(hpa);
+    free_packed_maze(maze);
+    return 0;
+}
+
+// --- BFS Paralela por Bits (Frente de Onda) ---
+
+// A frente de onda avança 64 células por operação: para cada linha,
+//   próxima = (F | F << 1 | F >> 1 | F_acima | F_abaixo) & aberta & ~visitada
+// com os deslocamentos atravessando as fronteiras entre palavras. Os bitmaps de
+// trabalho têm uma palavra de folga em cada ponta da linha e uma linha de folga
+// acima e abaixo (sempre zero), para que as leituras vizinhas dispensem testes.
+//
+// Em vez de uma cópia da frente por camada, cada célula guarda sua camada
+// módulo 3 em dois planos de bits (layer_lo, layer_hi): numa grade de custo
+// unitário, vizinhos têm distâncias d - 1, d ou d + 1, distintas módulo 3, o
+// que basta para reconstruir o caminho andando de E para trás.
+
+// Ponteiros de uma linha (palavra 0) nos bitmaps de trabalho
+typedef struct WavefrontRow {
+    const uint64_t* frontier; // Frente atual; frontier[-1] e frontier[words] são folgas
+    const uint64_t* up;       // Frente na linha de cima
+    const uint64_t* down;     // Frente na linha de baixo
+    const uint64_t* open;     // Células abertas
+    uint64_t* visited;
+    uint64_t* next;           // Saída: nova frente desta linha
+    uint64_t* layer_lo;       // Bit 0 da camada módulo 3
+    uint64_t* layer_hi;       // Bit 1 da camada módulo 3
+} WavefrontRow;
+
+// Expande uma linha; retorna true se a nova frente da linha não for vazia
+typedef bool (*WavefrontKernel)(const WavefrontRow* row, uint64_t mask_lo, uint64_t mask_hi, int words);
+
+// Expande uma palavra da linha (núcleo comum das versões escalares)
+static inline uint64_t wavefront_word(const WavefrontRow* row, int w, uint64_t mask_lo, uint64_t mask_hi) {
+    const uint64_t* f = row->frontier;
+    uint64_t x = f[w] | (f[w] << 1) | (f[w - 1] >> 63) | (f[w] >> 1) | (f[w + 1] << 63) |
+                 row->up[w] | row->down[w];
+    x &= row->open[w] & ~row->visited[w];
+    row->next[w] = x;
+    row->visited[w] |= x;
+    row->layer_lo[w] |= x & mask_lo;
+    row->layer_hi[w] |= x & mask_hi;
+    return x;
+}
+
+// Versão escalar (referência e fallback)
+bool wavefront_row_scalar(const WavefrontRow* row, uint64_t mask_lo, uint64_t mask_hi, int words) {
+    uint64_t any = 0;
+    for (int w = 0; w < words; w++) {
+        any |= wavefront_word(row, w, mask_lo, mask_hi);
+    }
+    return any != 0;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAS_SIMD_WAVEFRONT 1
+
+// 256 células por iteração; as palavras vizinhas (w - 1 e w + 1) vêm de leituras
+// desalinhadas deslocadas de uma palavra, sem permutações entre pistas
+__attribute__((target("avx2")))
+bool wavefront_row_avx2(const WavefrontRow* row, uint64_t mask_lo, uint64_t mask_hi, int words) {
+    const uint64_t* f = row->frontier;
+    const __m256i lo = _mm256_set1_epi64x((long long)mask_lo);
+    const __m256i hi = _mm256_set1_epi64x((long long)mask_hi);
+    __m256i any = _mm256_setzero_si256();
+    int w = 0;
+    for (; w + 4 <= words; w += 4) {
+        __m256i center = _mm256_loadu_si256((const __m256i*)&f[w]);
+        __m256i left = _mm256_loadu_si256((const __m256i*)&f[w - 1]);
+        __m256i right = _mm256_loadu_si256((const __m256i*)&f[w + 1]);
+        __m256i x = _mm256_or_si256(center, _mm256_slli_epi64(center, 1));
+        x = _mm256_or_si256(x, _mm256_srli_epi64(left, 63));
+        x = _mm256_or_si256(x, _mm256_srli_epi64(center, 1));
+        x = _mm256_or_si256(x, _mm256_slli_epi64(right, 63));
+        x = _mm256_or_si256(x, _mm256_loadu_si256((const __m256i*)&row->up[w]));
+        x = _mm256_or_si256(x, _mm256_loadu_si256((const __m256i*)&row->down[w]));
+        __m256i visited = _mm256_loadu_si256((const __m256i*)&row->visited[w]);
+        x = _mm256_andnot_si256(visited, _mm256_and_si256(x, _mm256_loadu_si256((const __m256i*)&row->open[w])));
+        _mm256_storeu_si256((__m256i*)&row->next[w], x);
+        _mm256_storeu_si256((__m256i*)&row->visited[w], _mm256_or_si256(visited, x));
+        __m256i layer = _mm256_loadu_si256((const __m256i*)&row->layer_lo[w]);
+        _mm256_storeu_si256((__m256i*)&row->layer_lo[w], _mm256_or_si256(layer, _mm256_and_si256(x, lo)));
+        layer = _mm256_loadu_si256((const __m256i*)&row->layer_hi[w]);
+        _mm256_storeu_si256((__m256i*)&row->layer_hi[w], _mm256_or_si256(layer, _mm256_and_si256(x, hi)));
+        any = _mm256_or_si256(any, x);
+    }
+    bool found = !_mm256_testz_si256(any, any);
+    if (w < words) { // Cauda que não completa um vetor
+        WavefrontRow tail = {
+            &row->frontier[w], &row->up[w], &row->down[w], &row->open[w],
+            &row->visited[w], &row->next[w], &row->layer_lo[w], &row->layer_hi[w]
+        };
+        found |= wavefront_row_scalar(&tail, mask_lo, mask_hi, words - w);
+    }
+    return found;
+}
+#endif
+
+WavefrontKernel wavefront_kernel = NULL; // Escolhido na primeira chamada de bit_bfs()
+const char* wavefront_kernel_name = "escalar";
+
+// Escolhe a melhor versão da expansão suportada pela CPU em tempo de execução
+void select_wavefront_kernel(void) {
+    wavefront_kernel = wavefront_row_scalar;
+    wavefront_kernel_name = "escalar";
+#ifdef HAS_SIMD_WAVEFRONT
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        wavefront_kernel = wavefront_row_avx2;
+        wavefront_kernel_name = "AVX2";
+    }
+#endif
+}
+
+// Aloca um bitmap de trabalho zerado com folgas: (num_rows + 2) linhas de stride palavras
+static uint64_t* alloc_wavefront_bitmap(int num_rows, int stride) {
+    uint64_t* bits = (uint64_t*)calloc((size_t)(num_rows + 2) * stride, sizeof(uint64_t));
+    if (!bits) {
+        perror("Erro ao alocar bitmap da BFS por bits");
+        exit(EXIT_FAILURE);
+    }
+    return bits;
+}
+
+// Testa o bit de (r, c) em um bitmap de trabalho com folgas
+static inline bool wavefront_test(const uint64_t* bits, int stride, int r, int c) {
+    return (bits[(size_t)(r + 1) * stride + 1 + (c >> 6)] >> (c & 63)) & 1;
+}
+
+/**
+ * @brief BFS por frente de onda sobre o bitmap, 64 (ou 256, com AVX2) células por operação.
+ *
+ * A cada passo só são processadas as palavras ao redor da frente: para cada
+ * linha guarda-se a faixa de palavras que a frente ocupa, e linhas sem frente
+ * por perto são puladas. Experimental: nas medições do modo bench ela fica
+ * atrás de grid_bfs (por volta de 1,5 a 2 vezes mais lenta em 2001 x 2001), por
+ * isso não é usada no fluxo padrão.
+ *
+ * @param maze O labirinto compacto.
+ * @param start A célula de partida.
+ * @param end A célula de chegada.
+ * @param path Saída opcional (NULL): caminho alocado com distância + 1 índices de
+ *             nó (map_coord_to_index), de start a end; NULL se não houver caminho.
+ *             Deve ser liberado pelo chamador.
+ * @return A distância em passos de start a end, ou -1 se não houver caminho.
+ */
+int bit_bfs(const PackedMaze* maze, Cell start, Cell end, int** path) {
+    if (!wavefront_kernel) {
+        select_wavefront_kernel();
+    }
+    const MazeBitmap* walls = maze->walls;
+    int num_rows = walls->num_rows;
+    int num_cols = walls->num_cols;
+    int words = walls->words_per_row;
+    int stride = words + 2;
+
+    uint64_t* open = alloc_wavefront_bitmap(num_rows, stride);
+    uint64_t* visited = alloc_wavefront_bitmap(num_rows, stride);
+    uint64_t* frontier = alloc_wavefront_bitmap(num_rows, stride);
+    uint64_t* next = alloc_wavefront_bitmap(num_rows, stride);
+    uint64_t* layer_lo = alloc_wavefront_bitmap(num_rows, stride);
+    uint64_t* layer_hi = alloc_wavefront_bitmap(num_rows, stride);
+    for (int r = 0; r < num_rows; r++) {
+        const uint64_t* row = bitmap_row(walls, r);
+        uint64_t* out = &open[(size_t)(r + 1) * stride + 1];
+        for (int w = 0; w < words; w++) {
+            out[w] = ~row[w]; // As folgas do bitmap são parede, logo ficam 0 aqui
+        }
+    }
+    if (path) {
+        *path = NULL;
+    }
+
+    // Faixa de palavras ocupada pela frente em cada linha (índice r + 1, com folgas;
+    // faixa vazia: lo = words, hi = -1), para expandir só perto da frente
+    int* span = (int*)malloc(4 * (size_t)(num_rows + 2) * sizeof(int));
+    if (!span) {
+        perror("Erro ao alocar faixas da BFS por bits");
+        exit(EXIT_FAILURE);
+    }
+    int* frontier_lo = span;
+    int* frontier_hi = span + (num_rows + 2);
+    int* next_lo = span + 2 * (num_rows + 2);
+    int* next_hi = span + 3 * (num_rows + 2);
+    for (int r = 0; r < num_rows + 2; r++) {
+        frontier_lo[r] = next_lo[r] = words;
+        frontier_hi[r] = next_hi[r] = -1;
+    }
+
+    // Camada 0: a partida (camada 0 mod 3 = planos zerados)
+    size_t start_word = (size_t)(start.row + 1) * stride + 1 + (start.col >> 6);
+    frontier[start_word] = 1ULL << (start.col & 63);
+    visited[start_word] = frontier[start_word];
+    frontier_lo[start.row + 1] = frontier_hi[start.row + 1] = start.col >> 6;
+    int first_row = start.row, last_row = start.row;
+    int distance = 0;
+
+    while (!wavefront_test(visited, stride, end.row, end.col)) {
+        int layer = (distance + 1) % 3;
+        uint64_t mask_lo = (layer & 1) ? ~0ULL : 0;
+        uint64_t mask_hi = (layer & 2) ? ~0ULL : 0;
+        int lo = first_row > 0 ? first_row - 1 : 0;
+        int hi = last_row + 1 < num_rows ? last_row + 1 : num_rows - 1;
+        int next_first = num_rows, next_last = -1;
+        for (int r = lo; r <= hi; r++) {
+            // Palavras que podem ganhar células: a faixa da frente nas linhas r - 1..r + 1,
+            // alargada de uma palavra para o transporte horizontal
+            int a = frontier_lo[r], b = frontier_hi[r];
+            for (int k = r + 1; k <= r + 2; k++) {
+                if (frontier_lo[k] < a) a = frontier_lo[k];
+                if (frontier_hi[k] > b) b = frontier_hi[k];
+            }
+            if (a > b) {
+                continue;
+            }
+            a = a > 0 ? a - 1 : 0;
+            b = b + 1 < words ? b + 1 : words - 1;
+
+            size_t base = (size_t)(r + 1) * stride + 1 + a;
+            WavefrontRow row = {
+                &frontier[base], &frontier[base - stride], &frontier[base + stride], &open[base],
+                &visited[base], &next[base], &layer_lo[base], &layer_hi[base]
+            };
+            // A frente típica ocupa uma ou duas palavras por linha: faixas estreitas são
+            // expandidas em linha; só as largas passam pelo kernel vetorial
+            bool grew;
+            if (b - a < 4) {
+                uint64_t any = 0;
+                for (int w = 0; w <= b - a; w++) {
+                    any |= wavefront_word(&row, w, mask_lo, mask_hi);
+                }
+                grew = any != 0;
+            } else {
+                grew = wavefront_kernel(&row, mask_lo, mask_hi, b - a + 1);
+            }
+            if (grew) {
+                while (next[base] == 0) { // Faixa exata da nova frente nesta linha
+                    base++;
+                    a++;
+                }
+                while (next[(size_t)(r + 1) * stride + 1 + b] == 0) {
+                    b--;
+                }
+                next_lo[r + 1] = a;
+                next_hi[r + 1] = b;
+                if (r < next_first) next_first = r;
+                next_last = r;
+            }
+        }
+        // Zera a frente antiga nas faixas que ocupava e troca os buffers
+        for (int r = first_row; r <= last_row; r++) {
+            if (frontier_lo[r + 1] <= frontier_hi[r + 1]) {
+                memset(&frontier[(size_t)(r + 1) * stride + 1 + frontier_lo[r + 1]], 0,
+                       (size_t)(frontier_hi[r + 1] - frontier_lo[r + 1] + 1) * sizeof(uint64_t));
+            }
+            frontier_lo[r + 1] = words;
+            frontier_hi[r + 1] = -1;
+        }
+        if (next_last < 0) {
+            distance = -1; // A frente se extinguiu antes de chegar
+            break;
+        }
+        uint64_t* tmp = frontier;
+        frontier = next;
+        next = tmp;
+        int* tmp_span = frontier_lo;
+        frontier_lo = next_lo;
+        next_lo = tmp_span;
+        tmp_span = frontier_hi;
+        frontier_hi = next_hi;
+        next_hi = tmp_span;
+        first_row = next_first;
+        last_row = next_last;
+        distance++;
+    }
+    free(span);
+
+    if (path && distance >= 0) {
+        // Reconstrução: a partir de E, sempre para um vizinho visitado da camada anterior
+        int* cells = (int*)malloc((size_t)(distance + 1) * sizeof(int));
+        if (!cells) {
+            perror("Erro ao alocar caminho");
+            exit(EXIT_FAILURE);
+        }
+        const int dr[4] = {-1, 1, 0, 0};
+        const int dc[4] = {0, 0, -1, 1};
+        int r = end.row, c = end.col;
+        cells[distance] = map_coord_to_index(r, c, num_cols);
+        for (int d = distance; d > 0; d--) {
+            int previous = (d - 1) % 3;
+            for (int i = 0; i < 4; i++) {
+                int nr = r + dr[i], nc = c + dc[i];
+                if (is_valid(nr, nc, num_rows, num_cols) && wavefront_test(visited, stride, nr, nc) &&
+                    (int)wavefront_test(layer_lo, stride, nr, nc) + 2 * (int)wavefront_test(layer_hi, stride, nr, nc) == previous) {
+                    r = nr;
+                    c = nc;
+                    break;
+                }
+            }
+            cells[d - 1] = map_coord_to_index(r, c, num_cols);
+        }
+        *path = cells;
+    }
+
+    free(open);
+    free(visited);
+    free(frontier);
+    free(next);
+    free(layer_lo);
+    free(layer_hi);
+    return distance;
+}
+
+// --- Modo Servidor (Consultas Repetidas) ---
+
+// Buffers de busca alocados uma vez e reaproveitados a cada consulta
+typedef struct SearchWorkspace {
+    int num_rows;
+    int num_cols;
+    int* queue;       // Fila da BFS (uma posição por célula)
+    int* parent;      // Predecessores, válidos só onde stamp == epoch
+    uint32_t* stamp;  // Consulta em que a célula foi visitada pela última vez
+    uint32_t epoch;   // Número da consulta atual
+    int* path;        // Caminho da última consulta
+    char* text;       // Direções codificadas da última consulta
+    size_t text_capacity;
+} SearchWorkspace;
+
+// Aloca os buffers para um labirinto num_rows x num_cols
+SearchWorkspace* create_search_workspace(int num_rows, int num_cols) {
+    int num_cells = layout_num_cells(num_rows, num_cols);
+    SearchWorkspace* ws = (SearchWorkspace*)malloc(sizeof(SearchWorkspace));
+    if (!ws) {
+        perror("Erro ao alocar área de busca");
+        exit(EXIT_FAILURE);
+    }
+    ws->num_rows = num_rows;
+    ws->num_cols = num_cols;
+    ws->queue = (int*)malloc((size_t)num_rows * num_cols * sizeof(int));
+    ws->parent = (int*)malloc((size_t)num_cells * sizeof(int));
+    ws->stamp = (uint32_t*)calloc((size_t)num_cells, sizeof(uint32_t));
+    ws->path = (int*)malloc((size_t)num_rows * num_cols * sizeof(int));
+    ws->text_capacity = 256;
+    ws->text = (char*)malloc(ws->text_capacity);
+    if (!ws->queue || !ws->parent || !ws->stamp || !ws->path || !ws->text) {
+        perror("Erro ao alocar área de busca");
+        exit(EXIT_FAILURE);
+    }
+    ws->epoch = 0;
+    return ws;
+}
+
+// Libera os buffers de busca
+void free_search_workspace(SearchWorkspace* ws) {
+    if (!ws) return;
+    free(ws->queue);
+    free(ws->parent);
+    free(ws->stamp);
+    free(ws->path);
+    free(ws->text);
+    free(ws);
+}
+
+/**
+ * @brief BFS de start até end reaproveitando os buffers da área de busca.
+ *
+ * Em vez de reinicializar visited/parent a cada consulta (O(células)), cada
+ * célula guarda o número da consulta em que foi visitada: basta incrementar
+ * epoch para "limpar" tudo. A busca para assim que end sai da fila.
+ *
+ * @param maze O labirinto compacto.
+ * @param ws A área de busca, criada com as dimensões do labirinto.
+ * @param start A célula de partida (aberta).
+ * @param end A célula de chegada (aberta).
+ * @return A distância em passos, ou -1 se end não for alcançável.
+ */
+int workspace_bfs(const PackedMaze* maze, SearchWorkspace* ws, Cell start, Cell end) {
+    int num_cols = ws->num_cols;
+    if (++ws->epoch == 0) {
+        // Contador deu a volta: zera as marcas uma única vez
+        memset(ws->stamp, 0, (size_t)layout_num_cells(ws->num_rows, num_cols) * sizeof(uint32_t));
+        ws->epoch = 1;
+    }
+    uint32_t epoch = ws->epoch;
+    int s = map_coord_to_index(start.row, start.col, num_cols);
+    int e = map_coord_to_index(end.row, end.col, num_cols);
+    int head = 0, tail = 0;
+    ws->stamp[s] = epoch;
+    ws->parent[s] = -1;
+    ws->queue[tail++] = s;
+
+    // Camada a camada, para saber a distância sem um array dist
+    for (int distance = 0; head < tail; distance++) {
+        int layer_end = tail;
+        while (head < layer_end) {
+            int u = ws->queue[head++];
+            if (u == e) {
+                return distance;
+            }
+            Cell cell;
+            map_index_to_coord(u, num_cols, &cell);
+            unsigned int open = packed_open_neighbors(maze, cell.row, cell.col);
+            int neighbors[4] = {
+                (open & 1) ? map_coord_to_index(cell.row - 1, cell.col, num_cols) : -1,
+                (open & 2) ? map_coord_to_index(cell.row + 1, cell.col, num_cols) : -1,
+                (open & 4) ? map_coord_to_index(cell.row, cell.col - 1, num_cols) : -1,
+                (open & 8) ? map_coord_to_index(cell.row, cell.col + 1, num_cols) : -1
+            };
+            for (int i = 0; i < 4; i++) {
+                int v = neighbors[i];
+                if (v != -1 && ws->stamp[v] != epoch) {
+                    ws->stamp[v] = epoch;
+                    ws->parent[v] = u;
+                    ws->queue[tail++] = v;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Responde a uma linha de consulta "r1 c1 r2 c2".
+ *
+ * Resposta em uma linha: "<distância> <direções>" (ex.: "13 D3 R5 U1 R2 U2"),
+ * "-1" se não houver caminho, ou "erro: ..." para consultas inválidas. Pares em
+ * regiões diferentes são rejeitados pelos rótulos de componentes sem busca.
+ *
+ * @return false se a linha pedir o fim da sessão ("fim").
+ */
+bool answer_query(const PackedMaze* maze, const MazeComponents* components, SearchWorkspace* ws,
+                  const char* line, FILE* out) {
+    Cell a, b;
+    char extra;
+    if (strncmp(line, "fim", 3) == 0) {
+        return false;
+    }
+    if (sscanf(line, "%d %d %d %d %c", &a.row, &a.col, &b.row, &b.col, &extra) != 4) {
+        fprintf(out, "erro: esperado \"r1 c1 r2 c2\"\n");
+        return true;
+    }
+    if (!is_valid(a.row, a.col, ws->num_rows, ws->num_cols) || !is_valid(b.row, b.col, ws->num_rows, ws->num_cols)) {
+        fprintf(out, "erro: célula fora do labirinto\n");
+        return true;
+    }
+    if (bitmap_is_wall(maze->walls, a.row, a.col) || bitmap_is_wall(maze->walls, b.row, b.col)) {
+        fprintf(out, "erro: célula é parede\n");
+        return true;
+    }
+    if (!same_component(components, a, b)) {
+        fprintf(out, "-1\n");
+        return true;
+    }
+
+    int distance = workspace_bfs(maze, ws, a, b);
+    int path_len = emit_path(ws->parent, map_coord_to_index(a.row, a.col, ws->num_cols),
+                             map_coord_to_index(b.row, b.col, ws->num_cols), ws->path, distance + 1);
+    size_t length = encode_path_rle(ws->path, path_len, ws->num_cols, NEIGHBORHOOD_4, ws->text, ws->text_capacity);
+    if (length >= ws->text_capacity) {
+        // Cresce uma vez e fica: consultas seguintes não realocam
+        ws->text_capacity = length + 1;
+        free(ws->text);
+        ws->text = (char*)malloc(ws->text_capacity);
+        if (!ws->text) {
+            perror("Erro ao alocar direções");
+            exit(EXIT_FAILURE);
+        }
+        encode_path_rle(ws->path, path_len, ws->num_cols, NEIGHBORHOOD_4, ws->text, ws->text_capacity);
+    }
+    fprintf(out, length > 0 ? "%d %s\n" : "%d\n", distance, ws->text);
+    return true;
+}
+
+// Atende consultas, uma por linha, até o fim da entrada ou "fim"
+bool serve_queries(const PackedMaze* maze, const MazeComponents* components, SearchWorkspace* ws, FILE* in,
+                   FILE* out) {
+    char line[256];
+    while (fgets(line, sizeof(line), in)) {
+        if (!answer_query(maze, components, ws, line, out)) {
+            fflush(out);
+            return false;
+        }
+        fflush(out); // Clientes interativos esperam a resposta antes da próxima consulta
+    }
+    return true;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_UNIX_SOCKETS 1
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Escuta no socket Unix 'path' e atende um cliente por vez, com o mesmo protocolo de linhas
+int serve_socket(const PackedMaze* maze, const MazeComponents* components, SearchWorkspace* ws, const char* path) {
+    struct sockaddr_un address;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Caminho de socket longo demais: '%s'\n", path);
+        return 1;
+    }
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("Erro ao criar socket");
+        return 1;
+    }
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+    unlink(path); // Remove um socket antigo que tenha sobrado
+    if (bind(listener, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(listener, 8) < 0) {
+        perror("Erro ao escutar no socket");
+        close(listener);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN); // Cliente que desconecta no meio não derruba o servidor
+    fprintf(stderr, "Aguardando consultas em '%s'.\n", path);
+
+    bool running = true;
+    while (running) {
+        int connection = accept(listener, NULL, NULL);
+        if (connection < 0) {
+            perror("Erro ao aceitar conexão");
+            continue;
+        }
+        int connection_out = dup(connection);
+        FILE* in = fdopen(connection, "r");
+        FILE* out = connection_out >= 0 ? fdopen(connection_out, "w") : NULL;
+        if (!in || !out) {
+            perror("Erro ao abrir conexão");
+            if (in) fclose(in); else close(connection);
+            if (out) fclose(out); else if (connection_out >= 0) close(connection_out);
+            continue;
+        }
+        running = serve_queries(maze, components, ws, in, out);
+        fclose(in);
+        fclose(out);
+    }
+    close(listener);
+    unlink(path);
+    return 0;
+}
+#endif
+
+// Modo "servidor": ./projeto1 servidor <labirinto.txt> [socket]
+// Carrega o labirinto e os rótulos de componentes uma única vez e responde
+// consultas "r1 c1 r2 c2" pela entrada padrão ou, se dado, por um socket Unix.
+// "fim" encerra o servidor.
+int server_command(int argc, char* argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Uso: %s servidor <labirinto.txt> [socket]\n", argv[0]);
+        return 1;
+    }
+    PackedMaze* maze = load_maze(argv[2]);
+    if (!maze) {
+        return 1;
+    }
+    clock_t begin = clock();
+    MazeComponents* components = label_components(maze);
+    SearchWorkspace* ws = create_search_workspace(maze->walls->num_rows, maze->walls->num_cols);
+    fprintf(stderr, "Labirinto %dx%d pronto em %.3f s (%d regiões conexas).\n", maze->walls->num_rows,
+            maze->walls->num_cols, (double)(clock() - begin) / CLOCKS_PER_SEC, components->num_components);
+
+    int status = 0;
+    if (argc >= 4) {
+#ifdef HAS_UNIX_SOCKETS
+        status = serve_socket(maze, components, ws, argv[3]);
+#else
+        fprintf(stderr, "Sockets Unix não disponíveis nesta plataforma; use a entrada padrão.\n");
+        status = 1;
+#endif
+    } else {
+        serve_queries(maze, components, ws, stdin, stdout);
+    }
+
+    free_search_workspace(ws);
+    free_maze_components(components);
+    free_packed_maze(maze);
+    return status;
+}
+
+// Modo "bench": ./projeto1 bench <linhas> <colunas> [semente] [repetições] [densidade]
+// Mede grid_bfs na disposição de células compilada (compare builds com
+// -DLAYOUT_MORTON e -DLAYOUT_TILED) e bit_bfs em um labirinto perfeito e em
+// um aleatório com a densidade de paredes dada (padrão 30%).
+int benchmark_command(int argc, char* argv[]) {
+    int num_rows = argc >= 4 ? atoi(argv[2]) : 0;
+    int num_cols = argc >= 4 ? atoi(argv[3]) : 0;
+    if (num_rows < 5 || num_cols < 5) {
+        fprintf(stderr, "Uso: %s bench <linhas> <colunas> [semente] [repetições] [densidade]\n", argv[0]);
+        return 1;
+    }
+    if (!layout_fits(num_rows, num_cols)) {
+        fprintf(stderr, "Labirinto %dx%d excede o limite de %d posições.\n", num_rows, num_cols, INT_MAX);
+        return 1;
+    }
+    uint64_t seed = argc >= 5 ? strtoull(argv[4], NULL, 10) : 1;
+    int repetitions = argc >= 6 ? atoi(argv[5]) : 3;
+    if (repetitions < 1) repetitions = 1;
+    double density = argc >= 7 ? atof(argv[6]) : 0.3;
+
+    printf("Disposição das células: %s (%d posições para %d células)\n", LAYOUT_NAME,
+           layout_num_cells(num_rows, num_cols), num_rows * num_cols);
+    int* dist = (int*)malloc((size_t)layout_num_cells(num_rows, num_cols) * sizeof(int));
+    if (!dist) {
+        perror("Erro ao alocar distâncias");
+        exit(EXIT_FAILURE);
+    }
+
+    const MazeGenerator generators[2] = {GEN_BACKTRACKER, GEN_RANDOM_FILL};
+    const char* names[2] = {"backtracker", "aleatorio"};
+    for (int g = 0; g < 2; g++) {
+        PackedMaze* maze = generate_maze(generators[g], num_rows, num_cols, seed, density);
+        double best = -1;
+        int reached = 0;
+        for (int k = 0; k < repetitions; k++) {
+            clock_t begin = clock();
+            reached = grid_bfs(maze, maze->start, dist, NULL);
+            double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+            if (best < 0 || seconds < best) best = seconds;
+        }
+        printf("%-16s BFS: %d células alcançadas em %.3f s (%.1f milhões de células/s)\n", names[g],
+               reached, best, best > 0 ? reached / best / 1e6 : 0.0);
+
+        // Mesma consulta S -> E pela frente de onda de bits
+        double best_bits = -1;
+        int distance = -1;
+        for (int k = 0; k < repetitions; k++) {
+            clock_t begin = clock();
+            distance = bit_bfs(maze, maze->start, maze->end, NULL);
+            double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+            if (best_bits < 0 || seconds < best_bits) best_bits = seconds;
+        }
+        printf("%-16s BFS por bits (%s): distância %d em %.3f s (BFS em grade: %d)\n", "", wavefront_kernel_name,
+               distance, best_bits, dist[map_coord_to_index(maze->end.row, maze->end.col, num_cols)]);
+
+        // Rotulagem única que responde qualquer consulta de alcance em O(1)
+        double best_labels = -1;
+        MazeComponents* components = NULL;
+        for (int k = 0; k < repetitions; k++) {
+            free_maze_components(components);
+            clock_t begin = clock();
+            components = label_components(maze);
+            double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+            if (best_labels < 0 || seconds < best_labels) best_labels = seconds;
+        }
+        printf("%-16s Componentes: %d regiões em %.3f s (S e E %s)\n", "", components->num_components,
+               best_labels, same_component(components, maze->start, maze->end) ? "conectados" : "desconexos");
+        free_maze_components(components);
+        free_packed_maze(maze);
+    }
+    free(dist);
+    return 0;
+}
+
+
+// --- Verificação de Consistência ---
+
+// Célula dentro da grade e aberta
+static bool verify_open(const PackedMaze* maze, int r, int c) {
+    return is_valid(r, c, maze->walls->num_rows, maze->walls->num_cols) && !bitmap_is_wall(maze->walls, r, c);
+}
+
+// Custo de referência do passo (r, c) -> (r2, c2), em décimos, escrito direto da
+// definição de cada vizinhança e independente dos núcleos; -1 se o passo não existe
+static int verify_step_cost(const PackedMaze* maze, Neighborhood neighborhood, bool use_terrain, int r, int c,
+                            int r2, int c2) {
+    if (!verify_open(maze, r2, c2)) return -1;
+    int dr = r2 - r, dc = c2 - c;
+    int base = 10;
+    switch (neighborhood) {
+        case NEIGHBORHOOD_4:
+            if (abs(dr) + abs(dc) != 1) return -1;
+            break;
+        case NEIGHBORHOOD_8:
+            if (abs(dr) > 1 || abs(dc) > 1 || (dr == 0 && dc == 0)) return -1;
+            if (dr != 0 && dc != 0) {
+                if (!verify_open(maze, r + dr, c) || !verify_open(maze, r, c + dc)) return -1; // Sem cortar quinas
+                base = 14;
+            }
+            break;
+        case NEIGHBORHOOD_HEX:
+            if (dr == 0) {
+                if (abs(dc) != 1) return -1;
+            } else {
+                int left = (r & 1) ? c : c - 1; // Linhas ímpares deslocadas meia célula para a direita
+                if (abs(dr) != 1 || (c2 != left && c2 != left + 1)) return -1;
+            }
+            break;
+    }
+    return base * (use_terrain ? packed_maze_cost(maze, r2, c2) : 1);
+}
+
+// Custos de referência (décimos) de start a todas as células por relaxação
+// repetida (Bellman-Ford), sem fila de prioridade; -1 onde não há caminho
+static void verify_reference_costs(const PackedMaze* maze, Neighborhood neighborhood, bool use_terrain, Cell start,
+                                   int cost[]) {
+    int num_rows = maze->walls->num_rows;
+    int num_cols = maze->walls->num_cols;
+    for (int i = 0; i < layout_num_cells(num_rows, num_cols); i++) {
+        cost[i] = -1;
+    }
+    cost[map_coord_to_index(start.row, start.col, num_cols)] = 0;
+    bool changed = true;
+    for (int pass = 0; changed; pass++) {
+        changed = false;
+        // Varreduras alternadas para a frente e para trás aceleram a convergência
+        for (int k = 0; k < num_rows * num_cols; k++) {
+            int cell = pass % 2 == 0 ? k : num_rows * num_cols - 1 - k;
+            int r = cell / num_cols, c = cell % num_cols;
+            int u = map_coord_to_index(r, c, num_cols);
+            if (cost[u] < 0) continue;
+            for (int dr = -1; dr <= 1; dr++) {
+                for (int dc = -1; dc <= 1; dc++) {
+                    int step = verify_step_cost(maze, neighborhood, use_terrain, r, c, r + dr, c + dc);
+                    if (step < 0) continue;
+                    int v = map_coord_to_index(r + dr, c + dc, num_cols);
+                    if (cost[v] < 0 || cost[u] + step < cost[v]) {
+                        cost[v] = cost[u] + step;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Custo (décimos) de um caminho de start a end em índices de nó; -1 se algum passo for inválido
+static int verify_path_cost(const PackedMaze* maze, Neighborhood neighborhood, bool use_terrain, const int path[],
+                            int path_len, Cell start, Cell end) {
+    int num_cols = maze->walls->num_cols;
+    if (path_len < 1 || path[0] != map_coord_to_index(start.row, start.col, num_cols) ||
+        path[path_len - 1] != map_coord_to_index(end.row, end.col, num_cols)) {
+        return -1;
+    }
+    int total = 0;
+    for (int i = 1; i < path_len; i++) {
+        Cell from, to;
+        map_index_to_coord(path[i - 1], num_cols, &from);
+        map_index_to_coord(path[i], num_cols, &to);
+        int step = verify_step_cost(maze, neighborhood, use_terrain, from.row, from.col, to.row, to.col);
+        if (step < 0) return -1;
+        total += step;
+    }
+    return total;
+}
+
+// Custo (décimos) do caminho registrado em parent[]; -1 se ele não ligar start a end por passos válidos
+static int verify_parent_cost(const PackedMaze* maze, Neighborhood neighborhood, bool use_terrain,
+                              const int parent[], Cell start, Cell end) {
+    int num_cols = maze->walls->num_cols;
+    int s = map_coord_to_index(start.row, start.col, num_cols);
+    int e = map_coord_to_index(end.row, end.col, num_cols);
+    int path_len = emit_path(parent, s, e, NULL, 0);
+    if (path_len == 0) return -1;
+    int* path = (int*)malloc(path_len * sizeof(int));
+    if (!path) {
+        perror("Erro ao alocar caminho");
+        exit(EXIT_FAILURE);
+    }
+    emit_path(parent, s, e, path, path_len);
+    int total = verify_path_cost(maze, neighborhood, use_terrain, path, path_len, start, end);
+    free(path);
+    return total;
+}
+
+// Labirinto sorteado (gerador, dimensões e densidade); metade recebe terreno de 1 a 9
+static PackedMaze* verify_random_maze(Rng* rng) {
+    int num_rows = 5 + (int)rng_below(rng, 30);
+    int num_cols = 5 + (int)rng_below(rng, 42);
+    MazeGenerator generator = (MazeGenerator)rng_below(rng, 4);
+    double density = 0.1 + 0.05 * rng_below(rng, 7);
+    PackedMaze* maze = generate_maze(generator, num_rows, num_cols, rng_next(rng), density);
+    if (rng_below(rng, 2)) {
+        int max_cost = 2 + (int)rng_below(rng, 8);
+        for (int r = 0; r < num_rows; r++) {
+            for (int c = 0; c < num_cols; c++) {
+                bool endpoint = (r == maze->start.row && c == maze->start.col) ||
+                                (r == maze->end.row && c == maze->end.col);
+                if (!endpoint && !bitmap_is_wall(maze->walls, r, c)) {
+                    packed_maze_set_char(maze, r, c, (char)('1' + rng_below(rng, max_cost)));
+                }
+            }
+        }
+    }
+    return maze;
+}
+
+// Sorteia uma célula aberta (S na falta de uma após algumas tentativas)
+static Cell verify_random_open_cell(const PackedMaze* maze, Rng* rng) {
+    for (int attempt = 0; attempt < 100; attempt++) {
+        Cell cell = {(int)rng_below(rng, maze->walls->num_rows), (int)rng_below(rng, maze->walls->num_cols)};
+        if (!bitmap_is_wall(maze->walls, cell.row, cell.col)) {
+            return cell;
+        }
+    }
+    return maze->start;
+}
+
+// Contadores de uma verificação: consultas feitas e respostas incorretas
+typedef struct VerifyTally {
+    const char* name;
+    int queries;
+    int mismatches;
+} VerifyTally;
+
+// Registra uma consulta e se ela foi respondida corretamente
+static void verify_count(VerifyTally* tally, bool ok) {
+    tally->queries++;
+    if (!ok) tally->mismatches++;
+}
+
+/**
+ * @brief Confere as buscas sem custo (grid_bfs, bit_bfs, workspace_bfs,
+ *        junction_dijkstra) e label_components contra a referência.
+ *
+ * A referência é a relaxação repetida na vizinhança de 4 com passos unitários.
+ * Além da distância, cada caminho devolvido precisa ligar as duas células por
+ * passos válidos. A primeira área de busca começa perto do limite de epoch para
+ * exercitar a volta do contador.
+ */
+static void verify_unit_searches(PackedMaze* maze, Rng* rng, int num_pairs, bool wrap_epoch, VerifyTally tally[5]) {
+    int num_rows = maze->walls->num_rows;
+    int num_cols = maze->walls->num_cols;
+    int num_cells = layout_num_cells(num_rows, num_cols);
+    int* reference = (int*)malloc((size_t)num_cells * sizeof(int));
+    int* dist = (int*)malloc((size_t)num_cells * sizeof(int));
+    int* parent = (int*)malloc((size_t)num_cells * sizeof(int));
+    if (!reference || !dist || !parent) {
+        perror("Erro ao alocar verificação");
+        exit(EXIT_FAILURE);
+    }
+    MazeComponents* components = label_components(maze);
+    SearchWorkspace* ws = create_search_workspace(num_rows, num_cols);
+    if (wrap_epoch) {
+        ws->epoch = UINT32_MAX - 1;
+    }
+    Graph* graph = build_graph_from_packed(maze);
+
+    for (int q = 0; q < num_pairs; q++) {
+        Cell a = q == 0 ? maze->start : verify_random_open_cell(maze, rng);
+        Cell b = q == 0 ? maze->end : verify_random_open_cell(maze, rng);
+        int s = map_coord_to_index(a.row, a.col, num_cols);
+        int e = map_coord_to_index(b.row, b.col, num_cols);
+        verify_reference_costs(maze, NEIGHBORHOOD_4, false, a, reference);
+        int expected = reference[e] < 0 ? -1 : reference[e] / 10;
+
+        // grid_bfs: o campo inteiro e o caminho até b
+        grid_bfs(maze, a, dist, parent);
+        bool ok = true;
+        for (int r = 0; r < num_rows; r++) {
+            for (int c = 0; c < num_cols; c++) {
+                int i = map_coord_to_index(r, c, num_cols);
+                if (!bitmap_is_wall(maze->walls, r, c) && dist[i] != (reference[i] < 0 ? -1 : reference[i] / 10)) {
+                    ok = false;
+                }
+            }
+        }
+        if (expected >= 0 && verify_parent_cost(maze, NEIGHBORHOOD_4, false, parent, a, b) != 10 * expected) {
+            ok = false;
+        }
+        verify_count(&tally[0], ok);
+
+        // bit_bfs
+        int* path = NULL;
+        int distance = bit_bfs(maze, a, b, &path);
+        ok = distance == expected &&
+             (expected < 0 || verify_path_cost(maze, NEIGHBORHOOD_4, false, path, distance + 1, a, b) == 10 * expected);
+        verify_count(&tally[1], ok);
+        free(path);
+
+        // workspace_bfs: os predecessores só valem nas células desta consulta
+        distance = workspace_bfs(maze, ws, a, b);
+        ok = distance == expected &&
+             (expected < 0 || verify_parent_cost(maze, NEIGHBORHOOD_4, false, ws->parent, a, b) == 10 * expected);
+        verify_count(&tally[2], ok);
+
+        // junction_dijkstra sobre o grafo contraído para este par
+        JunctionGraph* jg = contract_maze_graph(graph, s, e);
+        distance = junction_dijkstra(graph, jg, s, e, parent);
+        ok = distance == expected &&
+             (expected < 0 || verify_parent_cost(maze, NEIGHBORHOOD_4, false, parent, a, b) == 10 * expected);
+        verify_count(&tally[3], ok);
+        free_junction_graph(jg);
+
+        // label_components: mesma região exatamente onde a referência alcança
+        ok = true;
+        for (int r = 0; r < num_rows; r++) {
+            for (int c = 0; c < num_cols; c++) {
+                Cell cell = {r, c};
+                if (!bitmap_is_wall(maze->walls, r, c) &&
+                    same_component(components, a, cell) != (reference[map_coord_to_index(r, c, num_cols)] >= 0)) {
+                    ok = false;
+                }
+            }
+        }
+        verify_count(&tally[4], ok);
+    }
+
+    free_graph(graph);
+    free_search_workspace(ws);
+    free_maze_components(components);
+    free(reference);
+    free(dist);
+    free(parent);
+}
+
+// neighborhood_search nas três vizinhanças, Dijkstra e A*, contra a relaxação com terreno
+static void verify_terrain_searches(const PackedMaze* maze, Rng* rng, int num_pairs, VerifyTally tally[3]) {
+    int num_cols = maze->walls->num_cols;
+    int num_cells = layout_num_cells(maze->walls->num_rows, num_cols);
+    int* reference = (int*)malloc((size_t)num_cells * sizeof(int));
+    int* parent = (int*)malloc((size_t)num_cells * sizeof(int));
+    if (!reference || !parent) {
+        perror("Erro ao alocar verificação");
+        exit(EXIT_FAILURE);
+    }
+    for (int q = 0; q < num_pairs; q++) {
+        Cell a = verify_random_open_cell(maze, rng);
+        Cell b = verify_random_open_cell(maze, rng);
+        for (int n = NEIGHBORHOOD_4; n <= NEIGHBORHOOD_HEX; n++) {
+            verify_reference_costs(maze, (Neighborhood)n, true, a, reference);
+            int expected = reference[map_coord_to_index(b.row, b.col, num_cols)];
+            for (int heuristic = 0; heuristic < 2; heuristic++) {
+                int total = neighborhood_search(maze, (Neighborhood)n, a, b, heuristic == 1, parent, NULL);
+                bool ok = total == expected &&
+                          (expected < 0 || verify_parent_cost(maze, (Neighborhood)n, true, parent, a, b) == expected);
+                verify_count(&tally[n], ok);
+            }
+        }
+    }
+    free(reference);
+    free(parent);
+}
+
+// Compara duas abstrações HPA* campo a campo (ida e volta pelo arquivo)
+static bool verify_same_hpa_graph(const HpaGraph* a, const HpaGraph* b) {
+    if (a->num_rows != b->num_rows || a->num_cols != b->num_cols || a->cluster_size != b->cluster_size ||
+        a->min_cost != b->min_cost || a->fingerprint != b->fingerprint || a->num_nodes != b->num_nodes ||
+        a->num_edges != b->num_edges) {
+        return false;
+    }
+    // Sem transições ou arestas, os arrays correspondentes podem ser NULL
+    return (a->num_nodes == 0 || memcmp(a->node_cell, b->node_cell, a->num_nodes * sizeof(int)) == 0) &&
+           memcmp(a->edge_offset, b->edge_offset, (a->num_nodes + 1) * sizeof(int)) == 0 &&
+           (a->num_edges == 0 || (memcmp(a->edge_target, b->edge_target, a->num_edges * sizeof(int)) == 0 &&
+                                  memcmp(a->edge_cost, b->edge_cost, a->num_edges * sizeof(int)) == 0));
+}
+
+/**
+ * @brief Confere hpa_search: mesmo alcance que a referência, custo nunca abaixo
+ *        do ótimo e caminho válido com o custo informado.
+ *
+ * Com round_trip, a abstração passa antes por save_hpa_graph/load_hpa_graph e
+ * precisa voltar idêntica (contado em tally[1]).
+ */
+static void verify_hpa(const PackedMaze* maze, Rng* rng, int num_pairs, const char* filename, bool round_trip,
+                       VerifyTally tally[2]) {
+    int num_cols = maze->walls->num_cols;
+    int* reference = (int*)malloc((size_t)layout_num_cells(maze->walls->num_rows, num_cols) * sizeof(int));
+    if (!reference) {
+        perror("Erro ao alocar verificação");
+        exit(EXIT_FAILURE);
+    }
+    HpaGraph* hpa = build_hpa_graph(maze, 2 + (int)rng_below(rng, 15));
+    if (round_trip) {
+        HpaGraph* loaded = save_hpa_graph(hpa, filename) == 0 ? load_hpa_graph(filename) : NULL;
+        remove(filename);
+        verify_count(&tally[1], loaded && hpa_graph_matches(loaded, maze) && verify_same_hpa_graph(hpa, loaded));
+        if (loaded) {
+            free_hpa_graph(hpa);
+            hpa = loaded;
+        }
+    }
+    for (int q = 0; q < num_pairs; q++) {
+        Cell a = verify_random_open_cell(maze, rng);
+        Cell b = verify_random_open_cell(maze, rng);
+        verify_reference_costs(maze, NEIGHBORHOOD_4, true, a, reference);
+        int optimum = reference[map_coord_to_index(b.row, b.col, num_cols)];
+        int* path = NULL;
+        int path_len = 0;
+        int total = hpa_search(maze, hpa, a, b, &path, &path_len);
+        bool ok = (total < 0) == (optimum < 0);
+        if (ok && total >= 0) {
+            ok = 10 * total >= optimum &&
+                 verify_path_cost(maze, NEIGHBORHOOD_4, true, path, path_len, a, b) == 10 * total;
+        }
+        verify_count(&tally[0], ok);
+        free(path);
+    }
+    free_hpa_graph(hpa);
+    free(reference);
+}
+
+// Modo "verificar": ./projeto1 verificar [semente] [labirintos]
+// Confronta as buscas com uma referência por relaxação repetida em labirintos
+// sorteados (todos os geradores, com e sem terreno).
+int verification_command(int argc, char* argv[]) {
+    uint64_t seed = argc >= 3 ? strtoull(argv[2], NULL, 10) : 1;
+    int num_mazes = argc >= 4 ? atoi(argv[3]) : 300;
+    if (num_mazes < 1) num_mazes = 1;
+    const char* filename = "projeto1_verificacao.hpa";
+
+    VerifyTally unit[5] = {{"grid_bfs", 0, 0}, {"bit_bfs", 0, 0}, {"workspace_bfs", 0, 0},
+                           {"junction_dijkstra", 0, 0}, {"label_components", 0, 0}};
+    VerifyTally terrain[3] = {{"neighborhood_search (4)", 0, 0}, {"neighborhood_search (8)", 0, 0},
+                              {"neighborhood_search (hex)", 0, 0}};
+    VerifyTally hpa[2] = {{"hpa_search", 0, 0}, {"save_hpa_graph/load_hpa_graph", 0, 0}};
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (int m = 0; m < num_mazes; m++) {
+        PackedMaze* maze = verify_random_maze(&rng);
+        verify_unit_searches(maze, &rng, 3, m == 0, unit);
+        verify_terrain_searches(maze, &rng, 3, terrain);
+        verify_hpa(maze, &rng, 6, filename, m % 2 == 0, hpa);
+        free_packed_maze(maze);
+    }
+
+    printf("Disposição das células: %s; %d labirinto(s), semente %llu.\n", LAYOUT_NAME, num_mazes,
+           (unsigned long long)seed);
+    VerifyTally* groups[3] = {unit, terrain, hpa};
+    int group_sizes[3] = {5, 3, 2};
+    int failures = 0;
+    for (int g = 0; g < 3; g++) {
+        for (int i = 0; i < group_sizes[g]; i++) {
+            printf("%-30s %d divergência(s) em %d verificações.\n", groups[g][i].name, groups[g][i].mismatches,
+                   groups[g][i].queries);
+            failures += groups[g][i].mismatches;
+        }
+    }
+    printf(failures == 0 ? "Verificação concluída sem falhas.\n" : "Verificação encontrou falhas.\n");
+    return failures == 0 ? 0 : 1;
+}
+
+// --- Função Principal ---
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "gerar") == 0) {
+        return generate_command(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) {
+        return benchmark_command(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "servidor") == 0) {
+        return server_command(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "terreno") == 0) {
+        return terrain_command(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "hpa") == 0) {
+        return hpa_command(argc, argv);
+    }
+    if (argc >= 2 && strcmp(argv[1], "verificar") == 0) {
+        return verification_command(argc, argv);
+    }
+
+    // Exemplo de labirinto (pode ser ajustado)
+    char maze[MAX_ROWS][MAX_COLS] = {
+        {'#', '#', '#', '#', '#', '#', '#', '#', '#', '#'},
+        {'#', 'S', ' ', '#', ' ', ' ', ' ', '#', 'E', '#'},
+        {'#', ' ', ' ', '#', ' ', '#', ' ', '#', ' ', '#'},
+        {'#', ' ', '#', '#', ' ', '#', ' ', ' ', ' ', '#'},
+        {'#', ' ', ' ', ' ', ' ', ' ', ' ', '#', ' ', '#'},
+        {'#', '#', '#', '#', '#', '#', ' ', '#', ' ', '#'},
+        {'#', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '#'},
+        {'#', ' ', '#', '#', '#', '#', '#', '#', ' ', '#'},
+        {'#', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', '#'},
+        {'#', '#', '#', '#', '#', '#', '#', '#', '#', '#'}
+    };
+
+    int num_rows = 10;
+    int num_cols = 10;
+
+    // A grade acima é só o texto de entrada; a busca usa o formato compacto
+    PackedMaze* packed = pack_maze(&maze[0][0], num_rows, num_cols, MAX_COLS);
+    if (packed->start.row < 0 || packed->num_exits == 0) {
+        printf("Erro: Ponto de partida 'S' ou de chegada 'E' não encontrado no labirinto.\n");
+        free_packed_maze(packed);
+        return 1;
+    }
+
+    Graph* graph = build_graph_from_packed(packed);
+    int start_node = map_coord_to_index(packed->start.row, packed->start.col, num_cols);
+    int end_node = map_coord_to_index(packed->end.row, packed->end.col, num_cols);
+    int num_exits = packed->num_exits;
+    int* exits = (int*)malloc(num_exits * sizeof(int)); // Todas as saídas 'E' do labirinto
+    int* exit_dist = (int*)malloc(graph->num_nodes * sizeof(int));
+    int* nearest_exit = (int*)malloc(graph->num_nodes * sizeof(int));
+    if (!exits || !exit_dist || !nearest_exit) {
+        perror("Erro ao alocar campo de saídas");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < num_exits; i++) {
+        exits[i] = map_coord_to_index(packed->exits[i].row, packed->exits[i].col, num_cols);
+    }
+
+    printf("Labirinto:\n");
+    for (int r = 0; r < num_rows; r++) {
+        for (int c = 0; c < num_cols; c++) {
+            printf("%c ", packed_maze_char(packed, r, c));
+        }
+        printf("\n");
+    }
+
+    // Regiões conexas: se S e E estão em regiões diferentes, nenhuma busca é necessária
+    MazeComponents* components = label_components(packed);
+    printf("\nRegiões conexas: %d\n", components->num_components);
+    if (!same_component(components, packed->start, packed->end)) {
+        printf("Nenhum caminho encontrado: 'S' e 'E' estão em regiões desconexas.\n");
+    } else {
+        // Executar BFS
+        bfs(graph, start_node, end_node, num_rows, num_cols);
+
+        // Executar DFS
+        dfs(graph, start_node, end_node, num_rows, num_cols);
+
+        // Mesma consulta no grafo reduzido a junções
+        contracted_search(graph, start_node, end_node, num_cols);
+    }
+    free_maze_components(components);
+
+    // Distância de cada célula até a saída mais próxima (BFS com múltiplas origens)
+    multi_source_bfs(graph, exits, num_exits, exit_dist, nearest_exit, NULL);
+    printf("\n--- Distância até a Saída Mais Próxima (%d saída(s)) ---\n", num_exits);
+    print_cell_field(packed, exit_dist);
+    printf("\n--- Saída Mais Próxima de Cada Célula ---\n");
+    for (int i = 0; i < num_exits; i++) {
+        printf("Saída %d: (%d, %d)\n", i, packed->exits[i].row, packed->exits[i].col);
+    }
+    print_cell_field(packed, nearest_exit);
+    free(exits);
+    free(exit_dist);
+    free(nearest_exit);
+
+    // Campo completo a partir de 'S', exportado quando solicitado:
+    //   ./projeto1 campo <arquivo.bin> [imagem.pgm]
+    if (argc >= 3 && strcmp(argv[1], "campo") == 0) {
+        DistanceField* field = compute_distance_field(graph, start_node, num_rows, num_cols);
+        int status = save_distance_field(field, argv[2]);
+        if (status == 0 && argc >= 4) {
+            status = save_distance_field_pgm(field, argv[3]);
+        }
+        free_distance_field(field);
+
+        // Recarrega o arquivo e responde "caminho de S até E" sem nova busca
+        DistanceField* loaded = status == 0 ? load_distance_field(argv[2]) : NULL;
+        if (!loaded) {
+            free_packed_maze(packed);
+            free_graph(graph);
+            return 1;
+        }
+        printf("\n--- Campo de Distâncias Exportado para '%s' ---\n", argv[2]);
+        if (loaded->dist[end_node] == -1) {
+            printf("Nenhum caminho encontrado no campo carregado.\n");
+        } else {
+            printf("Distância de S até E pelo campo carregado: %d passos.\n", loaded->dist[end_node]);
+            print_path(loaded->parent, loaded->start_node, end_node, loaded->num_cols, NEIGHBORHOOD_4);
+        }
+        free_distance_field(loaded);
+    }
 
-    // Liberar memria alocada para o grafo
+    // Liberar memória alocada para o grafo e o labirinto
     free_graph(graph);
+    free_packed_maze(packed);
 
     return 0;
 }
\ No newline at end of file
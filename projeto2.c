@@ -3,30 +3,92 @@
 #include <stdbool.h>
 #include <limits.h> // Para INT_MAX
 #include <string.h>
+#include <stdint.h> // Para uint64_t e tipos de distância de largura fixa
+#include <float.h>  // Para FLT_MAX (distâncias em ponto flutuante)
+#include <time.h>   // Para clock() na calibração do Dijkstra
 
-// --- Definies Globais e Estruturas ---
+// --- Definições Globais e Estruturas ---
 
-#define MAX_NODES 20 // Nmero mximo de paradas/estaes na rede
-#define INFINITY INT_MAX // Representa uma distncia infinita (no conectada)
+#define MAX_NODES 20 // Número máximo de paradas/estações na rede
 
-// Estrutura para um n na lista de adjacncia (representa uma aresta)
+// Tipo das distâncias (dist_t) e dos pesos das arestas (weight_t), escolhido na
+// compilação com -DDIST_TYPE_UINT16, -DDIST_TYPE_UINT32, -DDIST_TYPE_UINT64 ou
+// -DDIST_TYPE_FLOAT (padrão: int). -DWEIGHT_TYPE_UINT16 reduz só os pesos a 16 bits,
+// mantendo distâncias mais largas. As somas saturam em INFINITY em vez de transbordar.
+#if defined(DIST_TYPE_UINT16)
+typedef uint16_t dist_t;
+#define DIST_MAX UINT16_MAX
+#elif defined(DIST_TYPE_UINT32)
+typedef uint32_t dist_t;
+#define DIST_MAX UINT32_MAX
+#elif defined(DIST_TYPE_UINT64)
+typedef uint64_t dist_t;
+#define DIST_MAX UINT64_MAX
+#elif defined(DIST_TYPE_FLOAT)
+typedef float dist_t;
+#define DIST_MAX FLT_MAX
+#else
+#define DIST_TYPE_INT 1
+typedef int dist_t;
+#define DIST_MAX INT_MAX
+#endif
+
+#if defined(WEIGHT_TYPE_UINT16) && !defined(DIST_TYPE_FLOAT)
+typedef uint16_t weight_t;
+#else
+typedef dist_t weight_t;
+#endif
+
+#define INFINITY DIST_MAX  // Representa uma distância infinita (não conectada)
+#define TIME_INFINITY INT_MAX // Horário inalcançável no quadro de horários
+
+// Soma saturada (distância + peso ou distância + distância): INFINITY absorve
+// qualquer parcela e somas que excederiam o tipo viram INFINITY
+static inline dist_t dist_add(dist_t a, dist_t b) {
+#ifdef DIST_TYPE_FLOAT
+    dist_t sum = a + b;
+    return sum >= INFINITY ? INFINITY : sum;
+#else
+    return (b >= INFINITY - a) ? INFINITY : (dist_t)(a + b);
+#endif
+}
+
+// Formata uma distância para impressão ("-1" se infinita)
+const char* format_distance(dist_t d, char buffer[], size_t size) {
+    if (d == INFINITY) {
+        snprintf(buffer, size, "-1");
+    } else {
+#ifdef DIST_TYPE_FLOAT
+        snprintf(buffer, size, "%g", (double)d);
+#else
+        snprintf(buffer, size, "%llu", (unsigned long long)d);
+#endif
+    }
+    return buffer;
+}
+
+// Estrutura para um nó na lista de adjacência (representa uma aresta)
 typedef struct AdjListNode {
-    int dest; // ndice do n de destino
-    int weight; // Peso da aresta (tempo de deslocamento)
+    int dest; // Índice do nó de destino
+    weight_t weight; // Peso da aresta (tempo de deslocamento)
     struct AdjListNode* next;
 } AdjListNode;
 
-// Estrutura para o Grafo (Lista de Adjacncia)
+// Estrutura para o Grafo (Lista de Adjacência)
 typedef struct Graph {
     int num_nodes;
-    AdjListNode** adj_lists; // Array de ponteiros para listas de adjacncia
-    char** node_names;       // Nomes das estaes/paradas
+    AdjListNode** adj_lists; // Array de ponteiros para listas de adjacência
+    char** node_names;       // Nomes das estações/paradas (apontam para name_pool)
+    char* name_pool;         // Todos os nomes, contíguos e terminados em '\0'
+    int name_pool_size;      // Bytes ocupados em name_pool
+    int name_pool_capacity;  // Bytes alocados para name_pool
+    unsigned int version;    // Incrementado a cada alteração nas arestas
 } Graph;
 
-// --- Funes Auxiliares do Grafo ---
+// --- Funções Auxiliares do Grafo ---
 
-// Cria um novo n da lista de adjacncia
-AdjListNode* create_adj_list_node(int dest, int weight) {
+// Cria um novo nó da lista de adjacência
+AdjListNode* create_adj_list_node(int dest, weight_t weight) {
     AdjListNode* new_node = (AdjListNode*)malloc(sizeof(AdjListNode));
     if (!new_node) {
         perror("Erro ao alocar AdjListNode");
@@ -38,7 +100,7 @@ AdjListNode* create_adj_list_node(int dest, int weight) {
     return new_node;
 }
 
-// Cria um grafo com 'num_nodes' ns
+// Cria um grafo com 'num_nodes' nós
 Graph* create_graph(int num_nodes) {
     Graph* graph = (Graph*)malloc(sizeof(Graph));
     if (!graph) {
@@ -50,7 +112,7 @@ Graph* create_graph(int num_nodes) {
     graph->node_names = (char**)malloc(num_nodes * sizeof(char*));
 
     if (!graph->adj_lists || !graph->node_names) {
-        perror("Erro ao alocar listas de adjacncia ou nomes dos ns");
+        perror("Erro ao alocar listas de adjacência ou nomes dos nós");
         free(graph->adj_lists);
         free(graph->node_names);
         free(graph);
@@ -59,35 +121,111 @@ Graph* create_graph(int num_nodes) {
 
     for (int i = 0; i < num_nodes; i++) {
         graph->adj_lists[i] = NULL;
-        graph->node_names[i] = NULL; // Inicializa com NULL, ser preenchido depois
+        graph->node_names[i] = NULL; // Inicializa com NULL, será preenchido depois
     }
+    graph->name_pool = NULL;
+    graph->name_pool_size = 0;
+    graph->name_pool_capacity = 0;
+    graph->version = 0;
     return graph;
 }
 
 // Adiciona uma aresta direcionada ao grafo (de src para dest com peso)
-void add_edge(Graph* graph, int src, int dest, int weight) {
-    // Adiciona dest  lista de src
+void add_edge(Graph* graph, int src, int dest, weight_t weight) {
+    // Adiciona dest à lista de src
     AdjListNode* new_node = create_adj_list_node(dest, weight);
     new_node->next = graph->adj_lists[src];
     graph->adj_lists[src] = new_node;
+    graph->version++; // Invalida resultados calculados sobre a versão anterior
 }
 
-// Define o nome de um n
+// Define (ou troca) o nome de um nó. Um novo nome que cabe no espaço do anterior
+// o sobrescreve; um maior vai para o fim do pool, e os nomes abandonados são
+// descartados na próxima vez que o pool precisar crescer.
 void set_node_name(Graph* graph, int node_index, const char* name) {
     if (node_index < 0 || node_index >= graph->num_nodes) {
-        fprintf(stderr, "Erro: ndice de n invlido.\n");
+        fprintf(stderr, "Erro: Índice de nó inválido.\n");
         return;
     }
-    // Aloca espao para o nome e copia
-    graph->node_names[node_index] = (char*)malloc(strlen(name) + 1);
-    if (!graph->node_names[node_index]) {
-        perror("Erro ao alocar nome do n");
-        exit(EXIT_FAILURE);
+    int length = (int)strlen(name) + 1;
+    char* old_name = graph->node_names[node_index];
+    if (old_name && (int)strlen(old_name) + 1 >= length) {
+        memmove(old_name, name, length); // 'name' pode apontar para o próprio pool
+        return;
+    }
+    graph->node_names[node_index] = NULL; // O nome anterior deixa de ser copiado
+
+    if (graph->name_pool_size + length > graph->name_pool_capacity) {
+        // Compacta os nomes vivos em um novo pool, ampliando-o se necessário
+        int live = 0;
+        for (int i = 0; i < graph->num_nodes; i++) {
+            if (graph->node_names[i]) {
+                live += (int)strlen(graph->node_names[i]) + 1;
+            }
+        }
+        int new_capacity = graph->name_pool_capacity ? graph->name_pool_capacity : 256;
+        while (new_capacity < live + length) {
+            new_capacity *= 2;
+        }
+        char* new_pool = (char*)malloc(new_capacity);
+        if (!new_pool) {
+            perror("Erro ao alocar nome do nó");
+            exit(EXIT_FAILURE);
+        }
+        int size = 0;
+        for (int i = 0; i < graph->num_nodes; i++) {
+            if (graph->node_names[i]) {
+                int name_length = (int)strlen(graph->node_names[i]) + 1;
+                memcpy(new_pool + size, graph->node_names[i], name_length);
+                graph->node_names[i] = new_pool + size;
+                size += name_length;
+            }
+        }
+        // Copia o novo nome antes de liberar o pool antigo, onde ele pode estar
+        memcpy(new_pool + size, name, length);
+        graph->node_names[node_index] = new_pool + size;
+        free(graph->name_pool);
+        graph->name_pool = new_pool;
+        graph->name_pool_size = size + length;
+        graph->name_pool_capacity = new_capacity;
+        return;
+    }
+    graph->node_names[node_index] = graph->name_pool + graph->name_pool_size;
+    memcpy(graph->node_names[node_index], name, length);
+    graph->name_pool_size += length;
+}
+
+// Altera o peso da aresta src -> dest (todas as cópias paralelas).
+// Retorna false se a aresta não existir; o menor peso anterior vai para 'old_weight'.
+bool update_edge_weight(Graph* graph, int src, int dest, weight_t new_weight, weight_t* old_weight) {
+    bool found = false;
+    for (AdjListNode* current = graph->adj_lists[src]; current; current = current->next) {
+        if (current->dest == dest) {
+            if (old_weight && (!found || current->weight < *old_weight)) {
+                *old_weight = current->weight;
+            }
+            found = true;
+            current->weight = new_weight;
+        }
     }
-    strcpy(graph->node_names[node_index], name);
+    if (found) {
+        graph->version++;
+    }
+    return found;
+}
+
+// Cria o grafo reverso (arestas invertidas, mesmos pesos, sem nomes)
+Graph* create_reverse_graph(const Graph* graph) {
+    Graph* reverse = create_graph(graph->num_nodes);
+    for (int u = 0; u < graph->num_nodes; u++) {
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            add_edge(reverse, current->dest, u, current->weight);
+        }
+    }
+    return reverse;
 }
 
-// Libera a memria do grafo
+// Libera a memória do grafo
 void free_graph(Graph* graph) {
     if (!graph) return;
     for (int i = 0; i < graph->num_nodes; i++) {
@@ -97,62 +235,480 @@ void free_graph(Graph* graph) {
             current = current->next;
             free(temp);
         }
-        free(graph->node_names[i]); // Libera o nome do n
     }
     free(graph->adj_lists);
     free(graph->node_names);
+    free(graph->name_pool); // Libera todos os nomes de uma só vez
     free(graph);
 }
 
+// --- Fila de Prioridade (Heap Binário) ---
+
+// Heap binário de mínimo indexado pelo nó, com diminuição de chave em O(log n)
+typedef struct MinHeap {
+    int size;
+    int capacity;
+    int* nodes;    // Nós em ordem de heap
+    dist_t* keys;  // Chave (distância) de cada nó
+    int* position; // Posição de cada nó em 'nodes', ou -1 se ausente
+} MinHeap;
+
+// Cria um heap para nós de 0 a capacity - 1
+MinHeap* create_min_heap(int capacity) {
+    MinHeap* heap = (MinHeap*)malloc(sizeof(MinHeap));
+    if (!heap) {
+        perror("Erro ao alocar heap");
+        exit(EXIT_FAILURE);
+    }
+    heap->size = 0;
+    heap->capacity = capacity;
+    heap->nodes = (int*)malloc(capacity * sizeof(int));
+    heap->keys = (dist_t*)malloc(capacity * sizeof(dist_t));
+    heap->position = (int*)malloc(capacity * sizeof(int));
+    if (!heap->nodes || !heap->keys || !heap->position) {
+        perror("Erro ao alocar heap");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < capacity; i++) {
+        heap->position[i] = -1;
+    }
+    return heap;
+}
+
+// Troca dois elementos do heap, atualizando suas posições
+void heap_swap(MinHeap* heap, int i, int j) {
+    int temp = heap->nodes[i];
+    heap->nodes[i] = heap->nodes[j];
+    heap->nodes[j] = temp;
+    heap->position[heap->nodes[i]] = i;
+    heap->position[heap->nodes[j]] = j;
+}
+
+// Insere o nó com a chave dada, ou diminui sua chave se já estiver no heap
+void heap_push_or_decrease(MinHeap* heap, int node, dist_t key) {
+    int i = heap->position[node];
+    if (i == -1) {
+        i = heap->size++;
+        heap->nodes[i] = node;
+        heap->position[node] = i;
+    } else if (key >= heap->keys[node]) {
+        return;
+    }
+    heap->keys[node] = key;
+    while (i > 0 && heap->keys[heap->nodes[(i - 1) / 2]] > key) {
+        heap_swap(heap, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+// Remove e retorna o nó de menor chave
+int heap_pop_min(MinHeap* heap) {
+    int min_node = heap->nodes[0];
+    heap->size--;
+    heap_swap(heap, 0, heap->size);
+    heap->position[min_node] = -1;
+
+    int i = 0;
+    while (true) {
+        int left = 2 * i + 1;
+        int right = left + 1;
+        int smallest = i;
+        if (left < heap->size && heap->keys[heap->nodes[left]] < heap->keys[heap->nodes[smallest]]) {
+            smallest = left;
+        }
+        if (right < heap->size && heap->keys[heap->nodes[right]] < heap->keys[heap->nodes[smallest]]) {
+            smallest = right;
+        }
+        if (smallest == i) break;
+        heap_swap(heap, i, smallest);
+        i = smallest;
+    }
+    return min_node;
+}
+
+// Verifica se o heap está vazio
+bool is_empty_heap(const MinHeap* heap) {
+    return heap->size == 0;
+}
+
+// Libera a memória do heap
+void free_min_heap(MinHeap* heap) {
+    if (!heap) return;
+    free(heap->nodes);
+    free(heap->keys);
+    free(heap->position);
+    free(heap);
+}
+
+// --- Índice de Nomes das Estações ---
+
+// Índice para localizar estações pelo nome: tabela hash de endereçamento aberto
+// (sondagem linear) para busca exata e uma trie para autocompletar por prefixo.
+// As strings não são copiadas: o índice consulta diretamente o pool do grafo.
+typedef struct NameIndex {
+    const Graph* graph;
+    int capacity;            // Tamanho da tabela hash (potência de 2)
+    int* slots;              // Índice do nó em cada posição, ou -1 se vazia
+    unsigned int* hashes;    // Hash armazenado para evitar comparações de string
+    int num_trie_nodes;
+    int trie_capacity;
+    int* trie_first_child;   // Primeiro filho de cada nó da trie (-1 se folha)
+    int* trie_next_sibling;  // Próximo irmão, em ordem crescente de caractere
+    int* trie_station;       // Estação cujo nome termina neste nó (-1 se nenhuma)
+    unsigned char* trie_char;
+} NameIndex;
+
+// Hash FNV-1a de uma string terminada em '\0'
+unsigned int hash_name(const char* name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash = (hash ^ *p) * 16777619u;
+    }
+    return hash;
+}
+
+// Cria um novo nó na trie e retorna seu índice
+int trie_new_node(NameIndex* index, unsigned char c) {
+    if (index->num_trie_nodes == index->trie_capacity) {
+        index->trie_capacity *= 2;
+        index->trie_first_child = (int*)realloc(index->trie_first_child, index->trie_capacity * sizeof(int));
+        index->trie_next_sibling = (int*)realloc(index->trie_next_sibling, index->trie_capacity * sizeof(int));
+        index->trie_station = (int*)realloc(index->trie_station, index->trie_capacity * sizeof(int));
+        index->trie_char = (unsigned char*)realloc(index->trie_char, index->trie_capacity);
+        if (!index->trie_first_child || !index->trie_next_sibling || !index->trie_station || !index->trie_char) {
+            perror("Erro ao realocar trie de nomes");
+            exit(EXIT_FAILURE);
+        }
+    }
+    int node = index->num_trie_nodes++;
+    index->trie_first_child[node] = -1;
+    index->trie_next_sibling[node] = -1;
+    index->trie_station[node] = -1;
+    index->trie_char[node] = c;
+    return node;
+}
+
+// Retorna o filho de 'node' com o caractere 'c', criando-o se 'create' for verdadeiro
+int trie_child(NameIndex* index, int node, unsigned char c, bool create) {
+    int prev = -1;
+    int child = index->trie_first_child[node];
+    while (child != -1 && index->trie_char[child] < c) {
+        prev = child;
+        child = index->trie_next_sibling[child];
+    }
+    if (child != -1 && index->trie_char[child] == c) {
+        return child;
+    }
+    if (!create) {
+        return -1;
+    }
+    // Insere mantendo os irmãos ordenados, para autocompletar em ordem alfabética
+    int new_node = trie_new_node(index, c);
+    index->trie_next_sibling[new_node] = child;
+    if (prev == -1) {
+        index->trie_first_child[node] = new_node;
+    } else {
+        index->trie_next_sibling[prev] = new_node;
+    }
+    return new_node;
+}
+
+/**
+ * @brief Constrói o índice de nomes sobre os nomes já definidos no grafo.
+ *
+ * @param graph O grafo com os nomes das estações.
+ * @return O índice pronto para consultas.
+ */
+NameIndex* build_name_index(const Graph* graph) {
+    NameIndex* index = (NameIndex*)malloc(sizeof(NameIndex));
+    if (!index) {
+        perror("Erro ao alocar índice de nomes");
+        exit(EXIT_FAILURE);
+    }
+    index->graph = graph;
+
+    // Tabela com fator de carga no máximo 1/2
+    index->capacity = 16;
+    while (index->capacity < 2 * graph->num_nodes) {
+        index->capacity *= 2;
+    }
+    index->slots = (int*)malloc(index->capacity * sizeof(int));
+    index->hashes = (unsigned int*)malloc(index->capacity * sizeof(unsigned int));
+
+    index->num_trie_nodes = 0;
+    index->trie_capacity = graph->name_pool_size + 1;
+    index->trie_first_child = (int*)malloc(index->trie_capacity * sizeof(int));
+    index->trie_next_sibling = (int*)malloc(index->trie_capacity * sizeof(int));
+    index->trie_station = (int*)malloc(index->trie_capacity * sizeof(int));
+    index->trie_char = (unsigned char*)malloc(index->trie_capacity);
+    if (!index->slots || !index->hashes || !index->trie_first_child ||
+        !index->trie_next_sibling || !index->trie_station || !index->trie_char) {
+        perror("Erro ao alocar índice de nomes");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < index->capacity; i++) {
+        index->slots[i] = -1;
+    }
+    trie_new_node(index, '\0'); // Raiz
+
+    for (int node = 0; node < graph->num_nodes; node++) {
+        const char* name = graph->node_names[node];
+        if (!name) continue;
+
+        unsigned int hash = hash_name(name);
+        int mask = index->capacity - 1;
+        int slot = (int)(hash & (unsigned int)mask);
+        while (index->slots[slot] != -1) {
+            if (index->hashes[slot] == hash && strcmp(graph->node_names[index->slots[slot]], name) == 0) {
+                break; // Nome repetido: mantém a primeira estação
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (index->slots[slot] == -1) {
+            index->slots[slot] = node;
+            index->hashes[slot] = hash;
+        }
+
+        int trie_node = 0;
+        for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+            trie_node = trie_child(index, trie_node, *p, true);
+        }
+        if (index->trie_station[trie_node] == -1) {
+            index->trie_station[trie_node] = node;
+        }
+    }
+    return index;
+}
+
+// Busca exata: retorna o índice da estação com o nome dado, ou -1
+int find_node_by_name(const NameIndex* index, const char* name) {
+    unsigned int hash = hash_name(name);
+    int mask = index->capacity - 1;
+    int slot = (int)(hash & (unsigned int)mask);
+    while (index->slots[slot] != -1) {
+        if (index->hashes[slot] == hash && strcmp(index->graph->node_names[index->slots[slot]], name) == 0) {
+            return index->slots[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+/**
+ * @brief Autocompletar: estações cujo nome começa com o prefixo, em ordem alfabética.
+ *
+ * @param index O índice de nomes.
+ * @param prefix O prefixo digitado.
+ * @param matches Array de saída com os índices das estações.
+ * @param max_matches Capacidade de 'matches'.
+ * @return Número de estações encontradas (no máximo max_matches).
+ */
+int autocomplete_station(NameIndex* index, const char* prefix, int matches[], int max_matches) {
+    int node = 0;
+    for (const unsigned char* p = (const unsigned char*)prefix; *p && node != -1; p++) {
+        node = trie_child(index, node, *p, false);
+    }
+    if (node == -1 || max_matches <= 0) {
+        return 0;
+    }
+
+    // Percurso em pré-ordem da subárvore com pilha explícita
+    int* stack = (int*)malloc(index->num_trie_nodes * sizeof(int));
+    if (!stack) {
+        perror("Erro ao alocar pilha do autocompletar");
+        exit(EXIT_FAILURE);
+    }
+    int top = 0;
+    int count = 0;
+    stack[top++] = node;
+    while (top > 0 && count < max_matches) {
+        int current = stack[--top];
+        if (index->trie_station[current] != -1) {
+            matches[count++] = index->trie_station[current];
+        }
+        // Empilha os filhos em ordem inversa para visitá-los em ordem crescente
+        int first = top;
+        for (int child = index->trie_first_child[current]; child != -1; child = index->trie_next_sibling[child]) {
+            stack[top++] = child;
+        }
+        for (int i = first, j = top - 1; i < j; i++, j--) {
+            int temp = stack[i];
+            stack[i] = stack[j];
+            stack[j] = temp;
+        }
+    }
+    free(stack);
+    return count;
+}
+
+// Libera a memória do índice de nomes
+void free_name_index(NameIndex* index) {
+    if (!index) return;
+    free(index->slots);
+    free(index->hashes);
+    free(index->trie_first_child);
+    free(index->trie_next_sibling);
+    free(index->trie_station);
+    free(index->trie_char);
+    free(index);
+}
+
 // --- Algoritmo de Dijkstra ---
 
+// Busca do mínimo na versão densa do Dijkstra: o vetor 'key' contém dist[v] para
+// nós não visitados e INFINITY para os visitados, de modo que a escolha do próximo
+// nó é um argmin sem desvios condicionais, vetorizável com SSE4.1/AVX2 quando
+// dist_t é int. Em caso de empate vence o maior índice, como no laço original
+// (dist[v] <= min_dist).
+typedef int (*ArgminKernel)(const dist_t keys[], int n);
+
+// Versão escalar (referência e fallback)
+int argmin_scalar(const dist_t keys[], int n) {
+    dist_t min_key = INFINITY;
+    int index = -1;
+    for (int v = 0; v < n; v++) {
+        if (keys[v] <= min_key) {
+            min_key = keys[v];
+            index = v;
+        }
+    }
+    return index;
+}
+
+#if defined(DIST_TYPE_INT) && (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define HAS_SIMD_ARGMIN 1
+
+// Combina as pistas de um vetor: menor chave e, entre as iguais, o maior índice
+int argmin_reduce_lanes(const int lane_min[], const int lane_index[], int lanes,
+                        const dist_t keys[], int start, int n) {
+    int min_key = INT_MAX;
+    int index = -1;
+    for (int i = 0; i < lanes; i++) {
+        if (lane_index[i] != -1 && (lane_min[i] < min_key ||
+                                    (lane_min[i] == min_key && lane_index[i] > index))) {
+            min_key = lane_min[i];
+            index = lane_index[i];
+        }
+    }
+    for (int v = start; v < n; v++) { // Cauda que não completa um vetor
+        if (keys[v] <= min_key) {
+            min_key = keys[v];
+            index = v;
+        }
+    }
+    return index;
+}
+
+__attribute__((target("sse4.1")))
+int argmin_sse41(const dist_t keys[], int n) {
+    __m128i best = _mm_set1_epi32(INT_MAX);
+    __m128i best_index = _mm_set1_epi32(-1);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    int v = 0;
+    for (; v + 4 <= n; v += 4) {
+        __m128i k = _mm_loadu_si128((const __m128i*)&keys[v]);
+        __m128i take = _mm_xor_si128(_mm_cmpgt_epi32(k, best), _mm_set1_epi32(-1)); // k <= best
+        best = _mm_min_epi32(best, k);
+        best_index = _mm_blendv_epi8(best_index, index, take);
+        index = _mm_add_epi32(index, step);
+    }
+    int lane_min[4], lane_index[4];
+    _mm_storeu_si128((__m128i*)lane_min, best);
+    _mm_storeu_si128((__m128i*)lane_index, best_index);
+    return argmin_reduce_lanes(lane_min, lane_index, 4, keys, v, n);
+}
+
+__attribute__((target("avx2")))
+int argmin_avx2(const dist_t keys[], int n) {
+    __m256i best = _mm256_set1_epi32(INT_MAX);
+    __m256i best_index = _mm256_set1_epi32(-1);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i step = _mm256_set1_epi32(8);
+    int v = 0;
+    for (; v + 8 <= n; v += 8) {
+        __m256i k = _mm256_loadu_si256((const __m256i*)&keys[v]);
+        __m256i take = _mm256_xor_si256(_mm256_cmpgt_epi32(k, best), _mm256_set1_epi32(-1)); // k <= best
+        best = _mm256_min_epi32(best, k);
+        best_index = _mm256_blendv_epi8(best_index, index, take);
+        index = _mm256_add_epi32(index, step);
+    }
+    int lane_min[8], lane_index[8];
+    _mm256_storeu_si256((__m256i*)lane_min, best);
+    _mm256_storeu_si256((__m256i*)lane_index, best_index);
+    return argmin_reduce_lanes(lane_min, lane_index, 8, keys, v, n);
+}
+#endif
+
+ArgminKernel argmin_kernel = NULL; // Escolhido na primeira chamada de dijkstra()
+const char* argmin_kernel_name = "escalar";
+
+// Escolhe a melhor versão do argmin suportada pela CPU em tempo de execução
+void select_argmin_kernel(void) {
+    argmin_kernel = argmin_scalar;
+    argmin_kernel_name = "escalar";
+#ifdef HAS_SIMD_ARGMIN
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        argmin_kernel = argmin_avx2;
+        argmin_kernel_name = "AVX2";
+    } else if (__builtin_cpu_supports("sse4.1")) {
+        argmin_kernel = argmin_sse41;
+        argmin_kernel_name = "SSE4.1";
+    }
+#endif
+}
+
 /**
  * @brief Implementa o algoritmo de Dijkstra para encontrar o caminho de menor custo
- * de um n de origem para todos os outros ns.
+ * de um nó de origem para todos os outros nós.
  *
  * @param graph O grafo de transporte.
- * @param start_node O ndice do n de partida.
- * @param dist Array para armazenar as distncias mnimas do n de partida.
- * @param parent Array para armazenar os predecessores para reconstruo do caminho.
+ * @param start_node O índice do nó de partida.
+ * @param dist Array para armazenar as distâncias mínimas do nó de partida.
+ * @param parent Array para armazenar os predecessores para reconstrução do caminho.
  */
-void dijkstra(Graph* graph, int start_node, int dist[], int parent[]) {
+void dijkstra(Graph* graph, int start_node, dist_t dist[], int parent[]) {
     bool visited[graph->num_nodes];
+    dist_t key[graph->num_nodes]; // dist[v] se não visitado, INFINITY se visitado
+
+    if (!argmin_kernel) {
+        select_argmin_kernel();
+    }
 
-    // Inicializa distncias como INFINITY e visitados como false
+    // Inicializa distâncias como INFINITY e visitados como false
     for (int i = 0; i < graph->num_nodes; i++) {
         dist[i] = INFINITY;
+        key[i] = INFINITY;
         visited[i] = false;
         parent[i] = -1; // -1 indica nenhum pai
     }
 
-    dist[start_node] = 0; // Distncia do n inicial para ele mesmo  0
+    dist[start_node] = 0; // Distância do nó inicial para ele mesmo é 0
+    key[start_node] = 0;
 
-    // Encontra o caminho mais curto para todos os vrtices
+    // Encontra o caminho mais curto para todos os vértices
     for (int count = 0; count < graph->num_nodes - 1; count++) {
-        // Encontra o vrtice com a menor distncia no visitada
-        int min_dist = INFINITY;
-        int u = -1;
-
-        for (int v = 0; v < graph->num_nodes; v++) {
-            if (!visited[v] && dist[v] <= min_dist) {
-                min_dist = dist[v];
-                u = v;
-            }
-        }
+        // Encontra o vértice com a menor distância não visitada
+        int u = argmin_kernel(key, graph->num_nodes);
 
-        if (u == -1) break; // Todos os ns alcanveis foram processados
+        if (u == -1 || key[u] == INFINITY) break; // Todos os nós alcançáveis foram processados
 
-        visited[u] = true; // Marca o n como visitado
+        visited[u] = true; // Marca o nó como visitado
+        key[u] = INFINITY;
 
-        // Atualiza as distncias dos vrtices adjacentes ao n 'u'
+        // Atualiza as distâncias dos vértices adjacentes ao nó 'u'
         AdjListNode* current = graph->adj_lists[u];
         while (current) {
             int v = current->dest;
-            int weight = current->weight;
+            dist_t candidate = dist_add(dist[u], current->weight); // Soma saturada
 
-            // Se 'v' no foi visitado e existe um caminho mais curto atravs de 'u'
-            if (!visited[v] && dist[u] != INFINITY && dist[u] + weight < dist[v]) {
-                dist[v] = dist[u] + weight;
+            // Se 'v' não foi visitado e existe um caminho mais curto através de 'u'
+            if (!visited[v] && candidate < dist[v]) {
+                dist[v] = candidate;
+                key[v] = dist[v];
                 parent[v] = u; // Define 'u' como pai de 'v'
             }
             current = current->next;
@@ -160,118 +716,3629 @@ void dijkstra(Graph* graph, int start_node, int dist[], int parent[]) {
     }
 }
 
-// --- Funes de Impresso e Interao ---
+/**
+ * @brief Dijkstra com heap binário: O((V + E) log V), melhor para redes grandes e esparsas.
+ *
+ * Mesmos parâmetros e resultados de dijkstra() (em caso de empates, o predecessor
+ * escolhido pode diferir).
+ */
+void dijkstra_heap(Graph* graph, int start_node, dist_t dist[], int parent[]) {
+    for (int i = 0; i < graph->num_nodes; i++) {
+        dist[i] = INFINITY;
+        parent[i] = -1;
+    }
+    MinHeap* heap = create_min_heap(graph->num_nodes);
+    dist[start_node] = 0;
+    heap_push_or_decrease(heap, start_node, 0);
 
-// Imprime o caminho encontrado do incio ao fim
-void print_path(Graph* graph, int parent[], int start_node, int end_node) {
-    if (end_node == start_node) {
-        printf("Voc j est em '%s'.\n", graph->node_names[start_node]);
-        return;
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            int v = current->dest;
+            dist_t candidate = dist_add(dist[u], current->weight);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                heap_push_or_decrease(heap, v, dist[v]);
+            }
+        }
     }
-    if (parent[end_node] == -1 && end_node != start_node) {
-        printf("No h caminho disponvel de '%s' para '%s'.\n",
-               graph->node_names[start_node], graph->node_names[end_node]);
-        return;
+    free_min_heap(heap);
+}
+
+int dijkstra_crossover = 0; // Tamanho a partir do qual o heap vence; 0 = não calibrado
+
+/**
+ * @brief Mede dijkstra() (argmin vetorizado) contra dijkstra_heap() em grafos
+ * aleatórios de grau médio 4 e tamanhos crescentes.
+ *
+ * @return O menor número de nós em que a versão com heap foi mais rápida.
+ */
+int calibrate_dijkstra_crossover(void) {
+    const int max_size = 4096;
+    int crossover = max_size;
+    dist_t* dist = (dist_t*)malloc(max_size * sizeof(dist_t));
+    int* parent = (int*)malloc(max_size * sizeof(int));
+    if (!dist || !parent) {
+        perror("Erro ao alocar calibração do Dijkstra");
+        exit(EXIT_FAILURE);
     }
+    unsigned int seed = 12345u;
 
-    // Constri o caminho de trs para frente
-    int path[MAX_NODES];
-    int path_len = 0;
-    int current = end_node;
+    for (int n = 16; n <= max_size; n *= 2) {
+        Graph* graph = create_graph(n);
+        for (int e = 0; e < 4 * n; e++) {
+            seed = seed * 1103515245u + 12345u;
+            int src = (int)((seed >> 8) % (unsigned int)n);
+            seed = seed * 1103515245u + 12345u;
+            int dest = (int)((seed >> 8) % (unsigned int)n);
+            add_edge(graph, src, dest, (weight_t)(1 + (seed >> 4) % 60u));
+        }
 
-    while (current != -1 && current != start_node) {
-        path[path_len++] = current;
-        current = parent[current];
+        // Repete as execuções para que cada medição dure algo mensurável
+        int repetitions = 1 + (1 << 18) / (n * 4);
+        clock_t begin = clock();
+        for (int r = 0; r < repetitions; r++) {
+            dijkstra(graph, r % n, dist, parent);
+        }
+        clock_t dense_time = clock() - begin;
+
+        begin = clock();
+        for (int r = 0; r < repetitions; r++) {
+            dijkstra_heap(graph, r % n, dist, parent);
+        }
+        clock_t heap_time = clock() - begin;
+
+        free_graph(graph);
+        if (heap_time < dense_time) {
+            crossover = n;
+            break;
+        }
     }
-    path[path_len++] = start_node; // Adiciona o n inicial
 
-    printf("Melhor trajeto:\n");
-    for (int i = path_len - 1; i >= 0; i--) {
-        printf("-> %s", graph->node_names[path[i]]);
+    free(dist);
+    free(parent);
+    return crossover;
+}
+
+// Escolhe a versão do Dijkstra pelo tamanho do grafo. Atenção: a primeira chamada
+// executa calibrate_dijkstra_crossover(), um benchmark silencioso em grafos de até
+// 4096 nós (cerca de 0,1 s), antes de responder.
+void dijkstra_auto(Graph* graph, int start_node, dist_t dist[], int parent[]) {
+    if (dijkstra_crossover == 0) {
+        dijkstra_crossover = calibrate_dijkstra_crossover();
+    }
+    if (graph->num_nodes < dijkstra_crossover) {
+        dijkstra(graph, start_node, dist, parent);
+    } else {
+        dijkstra_heap(graph, start_node, dist, parent);
     }
-    printf("\n");
 }
 
-// --- Funo Principal ---
+// --- Cache de Rotas ---
 
-int main() {
-    // Nomes das estaes/paradas
-    const char* station_names[] = {
-        "Centro", "Rodoviaria", "Shopping", "Parque", "Hospital",
-        "Aeroporto", "Praia", "Bairro Norte", "Bairro Sul", "Terminal Central"
-    };
-    int num_stations = 10; // Usando apenas as 10 primeiras para este exemplo
+// Cache de resultados do Dijkstra em dois níveis, ambos com substituição CLOCK:
+// - rotas (origem, destino) com a distância e o caminho comprimido, em que cada
+//   salto é a posição da aresta na lista de adjacência do nó atual (1 byte);
+// - árvores completas (dist/parent) por origem, reaproveitadas para qualquer destino.
+// Qualquer alteração nas arestas (graph->version) invalida todo o conteúdo.
+typedef struct RouteCacheEntry {
+    int origin;        // -1 indica posição vazia
+    int destination;
+    dist_t distance;
+    int path_len;      // Número de saltos do caminho (-1 se não coube em max_hops)
+    bool referenced;   // Bit de referência do CLOCK
+} RouteCacheEntry;
 
-    Graph* graph = create_graph(num_stations);
+typedef struct RouteCache {
+    int num_nodes;
+    unsigned int graph_version;
 
-    // Atribui os nomes aos ns do grafo
-    for (int i = 0; i < num_stations; i++) {
-        set_node_name(graph, i, station_names[i]);
-    }
+    // Rotas (origem, destino)
+    int route_capacity;
+    int max_hops;               // Saltos reservados por rota em 'hops'
+    RouteCacheEntry* routes;
+    unsigned char* hops;        // route_capacity * max_hops bytes
+    int table_size;             // Tabela hash (potência de 2) de chave -> posição em 'routes'
+    int* table;                 // -1 indica posição vazia
+    int route_hand;             // Ponteiro do CLOCK
 
-    // Define as arestas (conexes e tempos de deslocamento)
-    // Formato: add_edge(grafo, origem_idx, destino_idx, tempo_em_minutos);
-    add_edge(graph, 0, 1, 10); // Centro -> Rodoviaria (10 min)
-    add_edge(graph, 0, 2, 15); // Centro -> Shopping (15 min)
-    add_edge(graph, 1, 0, 12); // Rodoviaria -> Centro (12 min - pode ser diferente!)
-    add_edge(graph, 1, 3, 20); // Rodoviaria -> Parque (20 min)
-    add_edge(graph, 2, 4, 8);  // Shopping -> Hospital (8 min)
-    add_edge(graph, 3, 5, 25); // Parque -> Aeroporto (25 min)
-    add_edge(graph, 4, 1, 7);  // Hospital -> Rodoviaria (7 min)
-    add_edge(graph, 4, 6, 18); // Hospital -> Praia (18 min)
-    add_edge(graph, 5, 9, 30); // Aeroporto -> Terminal Central (30 min)
-    add_edge(graph, 6, 9, 22); // Praia -> Terminal Central (22 min)
-    add_edge(graph, 7, 0, 5);  // Bairro Norte -> Centro (5 min)
-    add_edge(graph, 8, 0, 8);  // Bairro Sul -> Centro (8 min)
-    add_edge(graph, 9, 5, 28); // Terminal Central -> Aeroporto (28 min)
-    add_edge(graph, 9, 6, 20); // Terminal Central -> Praia (20 min)
-    add_edge(graph, 3, 8, 10); // Parque -> Bairro Sul (10 min)
+    // Árvores de caminhos mínimos por origem
+    int tree_capacity;
+    int* tree_origin;           // -1 indica posição vazia
+    bool* tree_referenced;
+    dist_t* tree_dist;          // tree_capacity * num_nodes
+    int* tree_parent;           // tree_capacity * num_nodes
+    int tree_hand;
 
+    // Estatísticas
+    long route_hits, route_misses;
+    long tree_hits, tree_misses;
+} RouteCache;
 
-    printf("Bem-vindo ao Sistema de Rotas de Transporte Pblico!\n");
-    printf("Estaes disponveis:\n");
-    for (int i = 0; i < num_stations; i++) {
-        printf("%2d. %s\n", i, graph->node_names[i]);
+// Esvazia o cache (as estatísticas são mantidas)
+void route_cache_clear(RouteCache* cache) {
+    for (int i = 0; i < cache->route_capacity; i++) {
+        cache->routes[i].origin = -1;
+        cache->routes[i].referenced = false;
     }
+    for (int i = 0; i < cache->table_size; i++) {
+        cache->table[i] = -1;
+    }
+    for (int i = 0; i < cache->tree_capacity; i++) {
+        cache->tree_origin[i] = -1;
+        cache->tree_referenced[i] = false;
+    }
+    cache->route_hand = 0;
+    cache->tree_hand = 0;
+}
 
-    int start_index = -1;
-    int end_index = -1;
+/**
+ * @brief Cria um cache de rotas para o grafo.
+ *
+ * @param graph O grafo de transporte.
+ * @param route_capacity Número máximo de pares (origem, destino) armazenados.
+ * @param tree_capacity Número máximo de árvores completas por origem.
+ * @param max_hops Saltos máximos de um caminho armazenado (caminhos maiores guardam só a distância).
+ * @return O cache vazio.
+ */
+RouteCache* create_route_cache(const Graph* graph, int route_capacity, int tree_capacity, int max_hops) {
+    RouteCache* cache = (RouteCache*)malloc(sizeof(RouteCache));
+    if (!cache) {
+        perror("Erro ao alocar cache de rotas");
+        exit(EXIT_FAILURE);
+    }
+    cache->num_nodes = graph->num_nodes;
+    cache->graph_version = graph->version;
+    cache->route_capacity = route_capacity > 0 ? route_capacity : 1;
+    cache->max_hops = max_hops > 0 ? max_hops : 1;
+    cache->tree_capacity = tree_capacity > 0 ? tree_capacity : 1;
+    cache->table_size = 16;
+    while (cache->table_size < 2 * cache->route_capacity) {
+        cache->table_size *= 2;
+    }
 
-    // Entrada interativa do usurio
-    printf("\nSelecione o ponto de partida (digite o nmero): ");
-    scanf("%d", &start_index);
-    if (start_index < 0 || start_index >= num_stations) {
-        printf("ndice de partida invlido.\n");
-        free_graph(graph);
-        return 1;
+    cache->routes = (RouteCacheEntry*)malloc(cache->route_capacity * sizeof(RouteCacheEntry));
+    cache->hops = (unsigned char*)malloc((size_t)cache->route_capacity * cache->max_hops);
+    cache->table = (int*)malloc(cache->table_size * sizeof(int));
+    cache->tree_origin = (int*)malloc(cache->tree_capacity * sizeof(int));
+    cache->tree_referenced = (bool*)malloc(cache->tree_capacity * sizeof(bool));
+    cache->tree_dist = (dist_t*)malloc((size_t)cache->tree_capacity * graph->num_nodes * sizeof(dist_t));
+    cache->tree_parent = (int*)malloc((size_t)cache->tree_capacity * graph->num_nodes * sizeof(int));
+    if (!cache->routes || !cache->hops || !cache->table || !cache->tree_origin ||
+        !cache->tree_referenced || !cache->tree_dist || !cache->tree_parent) {
+        perror("Erro ao alocar cache de rotas");
+        exit(EXIT_FAILURE);
     }
 
-    printf("Selecione o ponto de destino (digite o nmero): ");
-    scanf("%d", &end_index);
-    if (end_index < 0 || end_index >= num_stations) {
-        printf("ndice de destino invlido.\n");
-        free_graph(graph);
-        return 1;
+    cache->route_hits = cache->route_misses = 0;
+    cache->tree_hits = cache->tree_misses = 0;
+    route_cache_clear(cache);
+    return cache;
+}
+
+// Descarta o conteúdo se o grafo mudou desde que foi calculado
+void route_cache_validate(RouteCache* cache, const Graph* graph) {
+    if (cache->graph_version != graph->version) {
+        route_cache_clear(cache);
+        cache->graph_version = graph->version;
     }
+}
 
-    printf("\nCalculando rota de '%s' para '%s'...\n",
-           graph->node_names[start_index], graph->node_names[end_index]);
+// Posição inicial da chave (origem, destino) na tabela hash
+int route_cache_home(const RouteCache* cache, int origin, int destination) {
+    unsigned int key = (unsigned int)origin * 2654435761u ^ (unsigned int)destination * 40503u;
+    return (int)((key ^ (key >> 15)) & (unsigned int)(cache->table_size - 1));
+}
 
-    int dist[MAX_NODES];   // Distncia mnima do incio para cada n
-    int parent[MAX_NODES]; // Predecessor no caminho mais curto
+// Retorna a posição da tabela que contém a chave, ou a posição vazia onde ela entraria
+int route_cache_find(const RouteCache* cache, int origin, int destination) {
+    int mask = cache->table_size - 1;
+    int slot = route_cache_home(cache, origin, destination);
+    while (cache->table[slot] != -1) {
+        const RouteCacheEntry* entry = &cache->routes[cache->table[slot]];
+        if (entry->origin == origin && entry->destination == destination) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
 
-    dijkstra(graph, start_index, dist, parent);
+// Remove uma posição da tabela, deslocando para trás as chaves seguintes (sem lápides)
+void route_cache_unlink(RouteCache* cache, int slot) {
+    int mask = cache->table_size - 1;
+    int hole = slot;
+    int next = (slot + 1) & mask;
+    while (cache->table[next] != -1) {
+        const RouteCacheEntry* entry = &cache->routes[cache->table[next]];
+        int home = route_cache_home(cache, entry->origin, entry->destination);
+        // Move a chave para o buraco se ela não ficar antes da sua posição inicial
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            cache->table[hole] = cache->table[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    cache->table[hole] = -1;
+}
 
-    printf("\n--- Resultado do Trajeto ---\n");
-    printf("Tempo mnimo de viagem de '%s' para '%s': %d minutos.\n",
-           graph->node_names[start_index], graph->node_names[end_index],
-           (dist[end_index] == INFINITY) ? -1 : dist[end_index]); // -1 se no houver caminho
+/**
+ * @brief Retorna a árvore de caminhos mínimos (dist/parent) a partir de 'origin',
+ * calculando-a com dijkstra() apenas se ela não estiver no cache.
+ *
+ * @param cache O cache de rotas.
+ * @param graph O grafo de transporte.
+ * @param origin O nó de origem.
+ * @param parent Recebe o array de predecessores da árvore.
+ * @return O array de distâncias da árvore (válido até a próxima consulta ao cache).
+ */
+const dist_t* route_cache_tree(RouteCache* cache, Graph* graph, int origin, const int** parent) {
+    route_cache_validate(cache, graph);
 
-    if (dist[end_index] != INFINITY) {
-        print_path(graph, parent, start_index, end_index);
+    for (int i = 0; i < cache->tree_capacity; i++) {
+        if (cache->tree_origin[i] == origin) {
+            cache->tree_hits++;
+            cache->tree_referenced[i] = true;
+            *parent = &cache->tree_parent[(size_t)i * cache->num_nodes];
+            return &cache->tree_dist[(size_t)i * cache->num_nodes];
+        }
+    }
+    cache->tree_misses++;
+
+    // CLOCK: avança até encontrar uma árvore sem o bit de referência
+    while (cache->tree_origin[cache->tree_hand] != -1 && cache->tree_referenced[cache->tree_hand]) {
+        cache->tree_referenced[cache->tree_hand] = false;
+        cache->tree_hand = (cache->tree_hand + 1) % cache->tree_capacity;
     }
+    int victim = cache->tree_hand;
+    cache->tree_hand = (cache->tree_hand + 1) % cache->tree_capacity;
+
+    dist_t* dist = &cache->tree_dist[(size_t)victim * cache->num_nodes];
+    int* tree_parent = &cache->tree_parent[(size_t)victim * cache->num_nodes];
+    dijkstra(graph, origin, dist, tree_parent);
+    cache->tree_origin[victim] = origin;
+    cache->tree_referenced[victim] = true;
+
+    *parent = tree_parent;
+    return dist;
+}
+
+/**
+ * @brief Consulta uma rota (origem, destino), usando o cache sempre que possível.
+ *
+ * @param cache O cache de rotas.
+ * @param graph O grafo de transporte.
+ * @param origin O nó de origem.
+ * @param destination O nó de destino.
+ * @param path Array (num_nodes) que recebe os nós do caminho, ou NULL se não for necessário.
+ * @param path_len Recebe o número de nós do caminho (0 se não houver caminho).
+ * @return A distância mínima, ou INFINITY se não houver caminho.
+ */
+dist_t route_cache_query(RouteCache* cache, Graph* graph, int origin, int destination, int path[], int* path_len) {
+    route_cache_validate(cache, graph);
+
+    int slot = route_cache_find(cache, origin, destination);
+    int index = cache->table[slot];
+    if (index != -1 && ((path == NULL && path_len == NULL) || cache->routes[index].path_len != -1)) {
+        RouteCacheEntry* entry = &cache->routes[index];
+        cache->route_hits++;
+        entry->referenced = true;
+
+        // Descomprime o caminho percorrendo as listas de adjacência
+        if (path && entry->distance != INFINITY) {
+            const unsigned char* hops = &cache->hops[(size_t)index * cache->max_hops];
+            int current = origin;
+            path[0] = current;
+            for (int i = 0; i < entry->path_len; i++) {
+                AdjListNode* edge = graph->adj_lists[current];
+                for (int k = 0; k < hops[i]; k++) {
+                    edge = edge->next;
+                }
+                current = edge->dest;
+                path[i + 1] = current;
+            }
+        }
+        if (path_len) {
+            *path_len = entry->distance == INFINITY ? 0 : entry->path_len + 1;
+        }
+        return entry->distance;
+    }
+    cache->route_misses++;
+
+    const int* parent;
+    const dist_t* dist = route_cache_tree(cache, graph, origin, &parent);
+    dist_t distance = dist[destination];
+
+    // Reconstrói o caminho de trás para frente diretamente em 'path' (ou só o conta)
+    int length = 0;
+    if (distance != INFINITY) {
+        for (int v = destination; v != -1; v = parent[v]) {
+            length++;
+        }
+        if (path) {
+            int i = length;
+            for (int v = destination; v != -1; v = parent[v]) {
+                path[--i] = v;
+            }
+        }
+    }
+    if (path_len) {
+        *path_len = length;
+    }
+
+    // Escolhe a posição: reaproveita a da chave (entrada sem caminho) ou vítima do CLOCK
+    if (index == -1) {
+        while (cache->routes[cache->route_hand].origin != -1 && cache->routes[cache->route_hand].referenced) {
+            cache->routes[cache->route_hand].referenced = false;
+            cache->route_hand = (cache->route_hand + 1) % cache->route_capacity;
+        }
+        index = cache->route_hand;
+        cache->route_hand = (cache->route_hand + 1) % cache->route_capacity;
+
+        RouteCacheEntry* victim = &cache->routes[index];
+        if (victim->origin != -1) {
+            route_cache_unlink(cache, route_cache_find(cache, victim->origin, victim->destination));
+            slot = route_cache_find(cache, origin, destination);
+        }
+        cache->table[slot] = index;
+    }
+
+    RouteCacheEntry* entry = &cache->routes[index];
+    entry->origin = origin;
+    entry->destination = destination;
+    entry->distance = distance;
+    entry->referenced = true;
+    entry->path_len = 0;
+
+    // Comprime o caminho: posição de cada aresta na lista de adjacência (até 255)
+    if (distance != INFINITY) {
+        unsigned char* hops = &cache->hops[(size_t)index * cache->max_hops];
+        int num_hops = length - 1;
+        if (num_hops > cache->max_hops) {
+            entry->path_len = -1;
+        }
+        int v = destination;
+        for (int i = num_hops - 1; i >= 0 && entry->path_len != -1; i--) {
+            int u = parent[v];
+            int position = 0;
+            AdjListNode* edge = graph->adj_lists[u];
+            while (edge && edge->dest != v) {
+                edge = edge->next;
+                position++;
+            }
+            if (position > 255) {
+                entry->path_len = -1;
+            } else {
+                hops[i] = (unsigned char)position;
+            }
+            v = u;
+        }
+        if (entry->path_len != -1) {
+            entry->path_len = num_hops;
+        }
+    }
+    return distance;
+}
+
+// Imprime os contadores de acertos e falhas do cache
+void print_route_cache_stats(const RouteCache* cache) {
+    printf("Cache de rotas: %ld acerto(s), %ld falha(s); árvores: %ld acerto(s), %ld falha(s).\n",
+           cache->route_hits, cache->route_misses, cache->tree_hits, cache->tree_misses);
+}
+
+// Libera a memória do cache de rotas
+void free_route_cache(RouteCache* cache) {
+    if (!cache) return;
+    free(cache->routes);
+    free(cache->hops);
+    free(cache->table);
+    free(cache->tree_origin);
+    free(cache->tree_referenced);
+    free(cache->tree_dist);
+    free(cache->tree_parent);
+    free(cache);
+}
+
+// --- Atualização Incremental de Caminhos Mínimos ---
+
+// Árvore de caminhos mínimos mantida sob alterações de peso (SSSP dinâmico, no
+// estilo Ramalingam-Reps): cada alteração reprocessa apenas os nós afetados.
+typedef struct ShortestPathTree {
+    int source;
+    int num_nodes;
+    dist_t* dist;
+    int* parent;
+    Graph* reverse;  // Predecessores de cada nó, mantidos em sincronia com o grafo
+    MinHeap* heap;   // Reutilizado entre atualizações
+    bool* affected;  // Marcação temporária dos nós desconectados por um aumento
+    int* affected_list;
+} ShortestPathTree;
+
+// Cria a árvore de caminhos mínimos a partir de 'source' com uma execução de dijkstra()
+ShortestPathTree* create_shortest_path_tree(Graph* graph, int source) {
+    ShortestPathTree* tree = (ShortestPathTree*)malloc(sizeof(ShortestPathTree));
+    if (!tree) {
+        perror("Erro ao alocar árvore de caminhos mínimos");
+        exit(EXIT_FAILURE);
+    }
+    tree->source = source;
+    tree->num_nodes = graph->num_nodes;
+    tree->dist = (dist_t*)malloc(graph->num_nodes * sizeof(dist_t));
+    tree->parent = (int*)malloc(graph->num_nodes * sizeof(int));
+    tree->affected = (bool*)malloc(graph->num_nodes * sizeof(bool));
+    tree->affected_list = (int*)malloc(graph->num_nodes * sizeof(int));
+    if (!tree->dist || !tree->parent || !tree->affected || !tree->affected_list) {
+        perror("Erro ao alocar árvore de caminhos mínimos");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < graph->num_nodes; i++) {
+        tree->affected[i] = false;
+    }
+    tree->reverse = create_reverse_graph(graph);
+    tree->heap = create_min_heap(graph->num_nodes);
+    dijkstra(graph, source, tree->dist, tree->parent);
+    return tree;
+}
+
+// Propaga reduções de distância a partir dos nós no heap (Dijkstra parcial)
+int propagate_tree_updates(ShortestPathTree* tree, Graph* graph) {
+    int settled = 0;
+    while (!is_empty_heap(tree->heap)) {
+        int u = heap_pop_min(tree->heap);
+        settled++;
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            int v = current->dest;
+            dist_t candidate = dist_add(tree->dist[u], current->weight);
+            if (candidate < tree->dist[v]) {
+                tree->dist[v] = candidate;
+                tree->parent[v] = u;
+                heap_push_or_decrease(tree->heap, v, tree->dist[v]);
+            }
+        }
+    }
+    return settled;
+}
+
+/**
+ * @brief Altera o peso da aresta src -> dest e repara a árvore de caminhos mínimos.
+ *
+ * Redução: propaga a nova distância a partir de 'dest'. Aumento de uma aresta da
+ * árvore: desconecta a subárvore de 'dest', recalcula cada nó afetado a partir dos
+ * predecessores não afetados e propaga apenas dentro da região afetada.
+ *
+ * @param tree A árvore mantida.
+ * @param graph O grafo (o mesmo usado na criação da árvore).
+ * @param src Origem da aresta.
+ * @param dest Destino da aresta.
+ * @param new_weight O novo peso.
+ * @return Número de nós retirados do heap durante o reparo (0 se nenhuma distância
+ *         mudou), nos dois sentidos da alteração, ou -1 se a aresta não existir.
+ */
+int update_tree_edge_weight(ShortestPathTree* tree, Graph* graph, int src, int dest, weight_t new_weight) {
+    weight_t old_weight;
+    if (!update_edge_weight(graph, src, dest, new_weight, &old_weight)) {
+        return -1;
+    }
+    update_edge_weight(tree->reverse, dest, src, new_weight, NULL);
+
+    dist_t* dist = tree->dist;
+    int* parent = tree->parent;
+
+    if (new_weight < old_weight) {
+        dist_t candidate = dist_add(dist[src], new_weight);
+        if (candidate >= dist[dest]) {
+            return 0; // A aresta continua fora dos caminhos mínimos
+        }
+        dist[dest] = candidate;
+        parent[dest] = src;
+        heap_push_or_decrease(tree->heap, dest, dist[dest]);
+        return propagate_tree_updates(tree, graph);
+    }
+
+    if (new_weight == old_weight || parent[dest] != src) {
+        return 0; // Aumento fora da árvore não altera nenhuma distância
+    }
+
+    // Coleta a subárvore de 'dest' (nós cujo caminho mínimo usava a aresta)
+    int num_affected = 0;
+    tree->affected_list[num_affected++] = dest;
+    tree->affected[dest] = true;
+    for (int i = 0; i < num_affected; i++) {
+        int u = tree->affected_list[i];
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            int v = current->dest;
+            if (!tree->affected[v] && parent[v] == u) {
+                tree->affected[v] = true;
+                tree->affected_list[num_affected++] = v;
+            }
+        }
+    }
+    for (int i = 0; i < num_affected; i++) {
+        int v = tree->affected_list[i];
+        dist[v] = INFINITY;
+        parent[v] = -1;
+    }
+
+    // Melhor ligação de cada nó afetado a partir de predecessores não afetados
+    for (int i = 0; i < num_affected; i++) {
+        int v = tree->affected_list[i];
+        for (AdjListNode* current = tree->reverse->adj_lists[v]; current; current = current->next) {
+            int u = current->dest;
+            dist_t candidate = dist_add(dist[u], current->weight);
+            if (!tree->affected[u] && candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+            }
+        }
+        if (dist[v] != INFINITY) {
+            heap_push_or_decrease(tree->heap, v, dist[v]);
+        }
+    }
+    for (int i = 0; i < num_affected; i++) {
+        tree->affected[tree->affected_list[i]] = false;
+    }
+
+    // Nós não afetados já têm distância correta; a propagação só melhora os afetados
+    return propagate_tree_updates(tree, graph);
+}
+
+// Libera a memória da árvore de caminhos mínimos
+void free_shortest_path_tree(ShortestPathTree* tree) {
+    if (!tree) return;
+    free(tree->dist);
+    free(tree->parent);
+    free(tree->affected);
+    free(tree->affected_list);
+    free_graph(tree->reverse);
+    free_min_heap(tree->heap);
+    free(tree);
+}
+
+// --- A* com Landmarks (ALT) ---
+
+// Tabelas de distâncias até/desde k estações de referência (landmarks). Pela
+// desigualdade triangular, d(v, t) >= d(v, L) - d(t, L) e d(v, t) >= d(L, t) - d(L, v),
+// o que fornece ao A* uma heurística admissível sem coordenadas geográficas.
+// As tabelas são organizadas por nó (k valores contíguos por nó) para a consulta.
+typedef struct LandmarkTable {
+    int num_landmarks;
+    int num_nodes;
+    int* landmarks;
+    dist_t* from_landmark; // d(L, v) em [v * num_landmarks + i]
+    dist_t* to_landmark;   // d(v, L) em [v * num_landmarks + i]
+} LandmarkTable;
+
+/**
+ * @brief Pré-processamento ALT: escolhe k landmarks e calcula as tabelas com dijkstra().
+ *
+ * Os landmarks são escolhidos pela heurística do mais distante: cada novo landmark
+ * é o nó alcançável que maximiza a menor distância aos landmarks já escolhidos.
+ *
+ * @param graph O grafo de transporte.
+ * @param num_landmarks Número desejado de landmarks (k).
+ * @return As tabelas de distâncias.
+ */
+LandmarkTable* build_landmark_table(Graph* graph, int num_landmarks) {
+    int n = graph->num_nodes;
+    if (num_landmarks > n) num_landmarks = n;
+    if (num_landmarks < 1) num_landmarks = 1;
+
+    LandmarkTable* table = (LandmarkTable*)malloc(sizeof(LandmarkTable));
+    dist_t* dist = (dist_t*)malloc(n * sizeof(dist_t));
+    int* parent = (int*)malloc(n * sizeof(int));
+    dist_t* closest = (dist_t*)malloc(n * sizeof(dist_t)); // Menor distância a um landmark já escolhido
+    if (!table || !dist || !parent || !closest) {
+        perror("Erro ao alocar tabelas de landmarks");
+        exit(EXIT_FAILURE);
+    }
+    table->num_landmarks = num_landmarks;
+    table->num_nodes = n;
+    table->landmarks = (int*)malloc(num_landmarks * sizeof(int));
+    table->from_landmark = (dist_t*)malloc((size_t)n * num_landmarks * sizeof(dist_t));
+    table->to_landmark = (dist_t*)malloc((size_t)n * num_landmarks * sizeof(dist_t));
+    if (!table->landmarks || !table->from_landmark || !table->to_landmark) {
+        perror("Erro ao alocar tabelas de landmarks");
+        exit(EXIT_FAILURE);
+    }
+
+    Graph* reverse = create_reverse_graph(graph);
+
+    // O primeiro landmark é o nó mais distante do nó 0
+    dijkstra(graph, 0, dist, parent);
+    int next = 0;
+    for (int v = 0; v < n; v++) {
+        closest[v] = INFINITY;
+        if (dist[v] != INFINITY && dist[v] > dist[next]) {
+            next = v;
+        }
+    }
+
+    for (int i = 0; i < num_landmarks; i++) {
+        int landmark = next;
+        table->landmarks[i] = landmark;
+
+        dijkstra(graph, landmark, dist, parent);
+        for (int v = 0; v < n; v++) {
+            table->from_landmark[v * num_landmarks + i] = dist[v];
+            if (dist[v] < closest[v]) {
+                closest[v] = dist[v];
+            }
+        }
+        dijkstra(reverse, landmark, dist, parent);
+        for (int v = 0; v < n; v++) {
+            table->to_landmark[v * num_landmarks + i] = dist[v];
+            if (dist[v] < closest[v]) {
+                closest[v] = dist[v];
+            }
+        }
+
+        // Próximo: o nó ligado aos landmarks que está mais longe de todos eles
+        next = landmark;
+        dist_t best = 0;
+        for (int v = 0; v < n; v++) {
+            if (closest[v] != INFINITY && closest[v] > best) {
+                best = closest[v];
+                next = v;
+            }
+        }
+        if (best == 0) {
+            // Nenhum nó novo alcançável: escolhe um nó ainda isolado dos landmarks
+            for (int v = 0; v < n; v++) {
+                if (closest[v] == INFINITY) {
+                    next = v;
+                    break;
+                }
+            }
+        }
+    }
+
+    free_graph(reverse);
+    free(dist);
+    free(parent);
+    free(closest);
+    return table;
+}
+
+// Limite inferior de d(v, t) pelos landmarks; INFINITY se t for inalcançável a partir de v
+dist_t landmark_lower_bound(const LandmarkTable* table, int v, int t) {
+    int k = table->num_landmarks;
+    const dist_t* from_v = &table->from_landmark[v * k];
+    const dist_t* from_t = &table->from_landmark[t * k];
+    const dist_t* to_v = &table->to_landmark[v * k];
+    const dist_t* to_t = &table->to_landmark[t * k];
+    dist_t bound = 0;
+    for (int i = 0; i < k; i++) {
+        if (to_t[i] != INFINITY) {
+            if (to_v[i] == INFINITY) {
+                return INFINITY; // t alcança L, mas v não: v também não alcança t
+            }
+            // Diferenças só quando positivas: dist_t pode não ter sinal
+            if (to_v[i] > to_t[i] && to_v[i] - to_t[i] > bound) {
+                bound = to_v[i] - to_t[i];
+            }
+        }
+        if (from_t[i] != INFINITY && from_v[i] != INFINITY && from_t[i] > from_v[i] &&
+            from_t[i] - from_v[i] > bound) {
+            bound = from_t[i] - from_v[i];
+        }
+    }
+    return bound;
+}
+
+/**
+ * @brief Consulta ponto a ponto com A* guiado pelos limites dos landmarks.
+ *
+ * @param graph O grafo de transporte.
+ * @param table As tabelas de landmarks.
+ * @param start_node O nó de partida.
+ * @param end_node O nó de chegada.
+ * @param dist Array (num_nodes) com as distâncias dos nós alcançados.
+ * @param parent Array (num_nodes) para reconstrução do caminho (compatível com print_path()).
+ * @param settled Recebe o número de nós processados (pode ser NULL).
+ * @return A distância mínima, ou INFINITY se não houver caminho.
+ */
+dist_t alt_query(Graph* graph, const LandmarkTable* table, int start_node, int end_node,
+                 dist_t dist[], int parent[], int* settled) {
+    int n = graph->num_nodes;
+    bool* closed = (bool*)malloc(n * sizeof(bool));
+    if (!closed) {
+        perror("Erro ao alocar busca ALT");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        dist[i] = INFINITY;
+        parent[i] = -1;
+        closed[i] = false;
+    }
+    MinHeap* heap = create_min_heap(n);
+    int count = 0;
+
+    dist_t h_start = landmark_lower_bound(table, start_node, end_node);
+    if (h_start != INFINITY) {
+        dist[start_node] = 0;
+        heap_push_or_decrease(heap, start_node, h_start);
+    }
+
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        closed[u] = true;
+        count++;
+        if (u == end_node) break;
+
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            int v = current->dest;
+            dist_t candidate = dist_add(dist[u], current->weight);
+            if (closed[v] || candidate >= dist[v]) {
+                continue;
+            }
+            dist_t h = landmark_lower_bound(table, v, end_node);
+            if (h == INFINITY) {
+                continue; // Poda: o destino não é alcançável a partir de v
+            }
+            dist[v] = candidate;
+            parent[v] = u;
+            heap_push_or_decrease(heap, v, dist_add(dist[v], h));
+        }
+    }
+
+    if (settled) {
+        *settled = count;
+    }
+    free_min_heap(heap);
+    free(closed);
+    return dist[end_node];
+}
+
+// Libera a memória das tabelas de landmarks
+void free_landmark_table(LandmarkTable* table) {
+    if (!table) return;
+    free(table->landmarks);
+    free(table->from_landmark);
+    free(table->to_landmark);
+    free(table);
+}
+
+// --- Representação CSR e Arc-Flags ---
+
+#define MAX_REGIONS 64 // Uma palavra de 64 bits de flags por aresta
+
+// Grafo em formato CSR (Compressed Sparse Row): as arestas de cada nó ficam
+// contíguas, na mesma ordem das listas de adjacência do grafo original.
+typedef struct CsrGraph {
+    int num_nodes;
+    int num_edges;
+    int* offsets; // Início das arestas de cada nó (num_nodes + 1)
+    int* targets; // Destino de cada aresta
+    weight_t* weights; // Peso de cada aresta
+} CsrGraph;
+
+// Constrói a representação CSR a partir das listas de adjacência
+CsrGraph* build_csr(const Graph* graph) {
+    CsrGraph* csr = (CsrGraph*)malloc(sizeof(CsrGraph));
+    if (!csr) {
+        perror("Erro ao alocar grafo CSR");
+        exit(EXIT_FAILURE);
+    }
+    csr->num_nodes = graph->num_nodes;
+    csr->num_edges = 0;
+    for (int u = 0; u < graph->num_nodes; u++) {
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            csr->num_edges++;
+        }
+    }
+    csr->offsets = (int*)malloc((graph->num_nodes + 1) * sizeof(int));
+    csr->targets = (int*)malloc((csr->num_edges + 1) * sizeof(int));
+    csr->weights = (weight_t*)malloc((csr->num_edges + 1) * sizeof(weight_t));
+    if (!csr->offsets || !csr->targets || !csr->weights) {
+        perror("Erro ao alocar grafo CSR");
+        exit(EXIT_FAILURE);
+    }
+    int e = 0;
+    for (int u = 0; u < graph->num_nodes; u++) {
+        csr->offsets[u] = e;
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            csr->targets[e] = current->dest;
+            csr->weights[e] = current->weight;
+            e++;
+        }
+    }
+    csr->offsets[graph->num_nodes] = e;
+    return csr;
+}
+
+// Copia os pesos atuais do grafo para o CSR (a topologia deve ser a mesma)
+void csr_refresh_weights(CsrGraph* csr, const Graph* graph) {
+    int e = 0;
+    for (int u = 0; u < graph->num_nodes; u++) {
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            csr->weights[e++] = current->weight;
+        }
+    }
+}
+
+// Libera a memória do grafo CSR
+void free_csr(CsrGraph* csr) {
+    if (!csr) return;
+    free(csr->offsets);
+    free(csr->targets);
+    free(csr->weights);
+    free(csr);
+}
+
+/**
+ * @brief Particiona o grafo em regiões de tamanho semelhante.
+ *
+ * Cada região cresce por busca em largura (ignorando o sentido das arestas) a
+ * partir do primeiro nó ainda sem região, até atingir n / num_regions nós; se a
+ * componente se esgotar antes, a região continua a partir do próximo nó livre.
+ * A última região absorve os nós restantes.
+ *
+ * @param graph O grafo de transporte.
+ * @param num_regions Número desejado de regiões (até MAX_REGIONS).
+ * @param region Array (num_nodes) que recebe a região de cada nó.
+ * @return Número de regiões efetivamente criadas.
+ */
+int partition_graph(const Graph* graph, int num_regions, int region[]) {
+    int n = graph->num_nodes;
+    if (num_regions > MAX_REGIONS) num_regions = MAX_REGIONS;
+    if (num_regions > n) num_regions = n;
+    if (num_regions < 1) num_regions = 1;
+    int target_size = (n + num_regions - 1) / num_regions;
+
+    Graph* reverse = create_reverse_graph(graph);
+    int* queue = (int*)malloc(n * sizeof(int));
+    if (!queue) {
+        perror("Erro ao alocar fila do particionador");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        region[v] = -1;
+    }
+
+    int current_region = 0;
+    int region_size = 0;
+    for (int seed = 0; seed < n; seed++) {
+        if (region[seed] != -1) continue;
+
+        int head = 0, tail = 0;
+        queue[tail++] = seed;
+        region[seed] = current_region;
+        region_size++;
+        while (head < tail) {
+            int u = queue[head++];
+            // Vizinhos de saída e de entrada
+            for (int pass = 0; pass < 2; pass++) {
+                AdjListNode* current = pass == 0 ? graph->adj_lists[u] : reverse->adj_lists[u];
+                for (; current; current = current->next) {
+                    int v = current->dest;
+                    if (region[v] != -1) continue;
+                    if (region_size >= target_size && current_region < num_regions - 1) break;
+                    region[v] = current_region;
+                    region_size++;
+                    queue[tail++] = v;
+                }
+            }
+        }
+        if (region_size >= target_size && current_region < num_regions - 1) {
+            current_region++;
+            region_size = 0;
+        }
+    }
+
+    free(queue);
+    free_graph(reverse);
+    return region_size > 0 ? current_region + 1 : current_region;
+}
+
+// Arc-flags: para cada aresta, um bit por região indicando se ela pertence a
+// algum caminho mínimo até um nó daquela região. Os flags ficam em um array
+// paralelo a csr->weights; a partição independe dos pesos e pode ser reaproveitada.
+typedef struct ArcFlags {
+    CsrGraph* csr;
+    int num_regions;
+    int* region;        // Região de cada nó
+    uint64_t* flags;    // Flags de cada aresta (paralelo a csr->weights)
+    int* rev_offsets;   // CSR reverso: arestas que chegam a cada nó
+    int* rev_edges;     // Índice (no CSR direto) de cada aresta de chegada
+    int* rev_sources;   // Origem de cada aresta de chegada
+} ArcFlags;
+
+/**
+ * @brief Calcula os arc-flags com os pesos atuais do grafo.
+ *
+ * Arestas internas a uma região recebem o bit da região. Para cada nó de fronteira
+ * b (com aresta vinda de outra região), uma busca reversa a partir de b marca as
+ * arestas (u, v) com d(u, b) = w(u, v) + d(v, b).
+ *
+ * @param flags A estrutura criada por build_arc_flags().
+ * @param graph O grafo (mesma topologia), de onde são lidos os pesos.
+ */
+void compute_arc_flags(ArcFlags* flags, const Graph* graph) {
+    CsrGraph* csr = flags->csr;
+    int n = csr->num_nodes;
+    csr_refresh_weights(csr, graph);
+
+    for (int u = 0; u < n; u++) {
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            int v = csr->targets[e];
+            flags->flags[e] = (flags->region[u] == flags->region[v]) ? (1ULL << flags->region[v]) : 0;
+        }
+    }
+
+    dist_t* dist = (dist_t*)malloc(n * sizeof(dist_t));
+    if (!dist) {
+        perror("Erro ao alocar cálculo de arc-flags");
+        exit(EXIT_FAILURE);
+    }
+    MinHeap* heap = create_min_heap(n);
+
+    for (int b = 0; b < n; b++) {
+        // Apenas nós de fronteira: alguma aresta de chegada vem de outra região
+        bool boundary = false;
+        for (int i = flags->rev_offsets[b]; i < flags->rev_offsets[b + 1] && !boundary; i++) {
+            boundary = flags->region[flags->rev_sources[i]] != flags->region[b];
+        }
+        if (!boundary) continue;
+
+        // Dijkstra reverso a partir de b
+        for (int v = 0; v < n; v++) {
+            dist[v] = INFINITY;
+        }
+        dist[b] = 0;
+        heap_push_or_decrease(heap, b, 0);
+        while (!is_empty_heap(heap)) {
+            int v = heap_pop_min(heap);
+            for (int i = flags->rev_offsets[v]; i < flags->rev_offsets[v + 1]; i++) {
+                int e = flags->rev_edges[i];
+                int u = flags->rev_sources[i];
+                dist_t candidate = dist_add(dist[v], csr->weights[e]);
+                if (candidate < dist[u]) {
+                    dist[u] = candidate;
+                    heap_push_or_decrease(heap, u, dist[u]);
+                }
+            }
+        }
+
+        uint64_t bit = 1ULL << flags->region[b];
+        for (int u = 0; u < n; u++) {
+            if (dist[u] == INFINITY) continue;
+            for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+                int v = csr->targets[e];
+                if (dist[v] != INFINITY && dist_add(dist[v], csr->weights[e]) == dist[u]) {
+                    flags->flags[e] |= bit;
+                }
+            }
+        }
+    }
+
+    free_min_heap(heap);
+    free(dist);
+}
+
+/**
+ * @brief Particiona o grafo, monta o CSR e calcula os arc-flags.
+ *
+ * @param graph O grafo de transporte.
+ * @param num_regions Número desejado de regiões (até MAX_REGIONS).
+ * @return A estrutura de arc-flags.
+ */
+ArcFlags* build_arc_flags(const Graph* graph, int num_regions) {
+    ArcFlags* flags = (ArcFlags*)malloc(sizeof(ArcFlags));
+    if (!flags) {
+        perror("Erro ao alocar arc-flags");
+        exit(EXIT_FAILURE);
+    }
+    int n = graph->num_nodes;
+    flags->csr = build_csr(graph);
+    flags->region = (int*)malloc(n * sizeof(int));
+    flags->flags = (uint64_t*)malloc((flags->csr->num_edges + 1) * sizeof(uint64_t));
+    flags->rev_offsets = (int*)malloc((n + 1) * sizeof(int));
+    flags->rev_edges = (int*)malloc((flags->csr->num_edges + 1) * sizeof(int));
+    flags->rev_sources = (int*)malloc((flags->csr->num_edges + 1) * sizeof(int));
+    if (!flags->region || !flags->flags || !flags->rev_offsets || !flags->rev_edges || !flags->rev_sources) {
+        perror("Erro ao alocar arc-flags");
+        exit(EXIT_FAILURE);
+    }
+    flags->num_regions = partition_graph(graph, num_regions, flags->region);
+
+    // CSR reverso por contagem
+    CsrGraph* csr = flags->csr;
+    for (int v = 0; v <= n; v++) {
+        flags->rev_offsets[v] = 0;
+    }
+    for (int e = 0; e < csr->num_edges; e++) {
+        flags->rev_offsets[csr->targets[e] + 1]++;
+    }
+    for (int v = 0; v < n; v++) {
+        flags->rev_offsets[v + 1] += flags->rev_offsets[v];
+    }
+    int* fill = (int*)malloc((n + 1) * sizeof(int));
+    if (!fill) {
+        perror("Erro ao alocar arc-flags");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, flags->rev_offsets, (n + 1) * sizeof(int));
+    for (int u = 0; u < n; u++) {
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            int i = fill[csr->targets[e]]++;
+            flags->rev_edges[i] = e;
+            flags->rev_sources[i] = u;
+        }
+    }
+    free(fill);
+
+    compute_arc_flags(flags, graph);
+    return flags;
+}
+
+/**
+ * @brief Dijkstra ponto a ponto que ignora arestas sem o flag da região do destino.
+ *
+ * @param flags Os arc-flags calculados.
+ * @param start_node O nó de partida.
+ * @param end_node O nó de chegada.
+ * @param dist Array (num_nodes) com as distâncias dos nós alcançados.
+ * @param parent Array (num_nodes) para reconstrução do caminho (compatível com print_path()).
+ * @param settled Recebe o número de nós processados (pode ser NULL).
+ * @return A distância mínima, ou INFINITY se não houver caminho.
+ */
+dist_t dijkstra_arc_flags(const ArcFlags* flags, int start_node, int end_node,
+                          dist_t dist[], int parent[], int* settled) {
+    const CsrGraph* csr = flags->csr;
+    int n = csr->num_nodes;
+    for (int i = 0; i < n; i++) {
+        dist[i] = INFINITY;
+        parent[i] = -1;
+    }
+    uint64_t target_bit = 1ULL << flags->region[end_node];
+    MinHeap* heap = create_min_heap(n);
+    int count = 0;
+
+    dist[start_node] = 0;
+    heap_push_or_decrease(heap, start_node, 0);
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        count++;
+        if (u == end_node) break;
+
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            if (!(flags->flags[e] & target_bit)) {
+                continue; // A aresta não leva por caminho mínimo à região do destino
+            }
+            int v = csr->targets[e];
+            dist_t candidate = dist_add(dist[u], csr->weights[e]);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                parent[v] = u;
+                heap_push_or_decrease(heap, v, dist[v]);
+            }
+        }
+    }
+
+    if (settled) {
+        *settled = count;
+    }
+    free_min_heap(heap);
+    return dist[end_node];
+}
+
+// Libera a memória dos arc-flags
+void free_arc_flags(ArcFlags* flags) {
+    if (!flags) return;
+    free_csr(flags->csr);
+    free(flags->region);
+    free(flags->flags);
+    free(flags->rev_offsets);
+    free(flags->rev_edges);
+    free(flags->rev_sources);
+    free(flags);
+}
+
+// --- Customizable Route Planning (Overlay Multinível) ---
+
+#define CRP_MAX_LEVELS 4 // Níveis de partição do overlay
+#define CRP_FANOUT 4     // Células de um nível agrupadas em cada célula do nível acima
+
+// Um nível do overlay: partição dos nós em células, nós de fronteira de cada
+// célula e, após a customização, a matriz de distâncias entre eles (clique).
+typedef struct CrpLevel {
+    int num_cells;
+    int* cell;            // Célula de cada nó
+    int* boundary_offset; // Início dos nós de fronteira de cada célula (num_cells + 1)
+    int* boundary;        // Nós de fronteira agrupados por célula
+    int* boundary_index;  // Posição do nó entre as fronteiras da sua célula, ou -1
+    int* search_offset;   // Início dos nós de busca de cada célula (num_cells + 1)
+    int* search_nodes;    // Nós percorridos na customização: todos (nível 1) ou fronteiras do nível abaixo
+    int* search_index;    // Posição do nó entre os nós de busca da sua célula, ou -1
+    int* clique_offset;   // Início da matriz de cada célula em 'clique' (num_cells + 1)
+    dist_t* clique;       // Distâncias entre fronteiras (linha: entrada, coluna: saída)
+} CrpLevel;
+
+// Partição multinível (independente dos pesos) mais as cliques de cada célula.
+// A customização relê os pesos do grafo e recalcula todas as cliques; as células
+// de um nível são independentes e processadas em paralelo (compilar com -fopenmp).
+typedef struct CrpOverlay {
+    CsrGraph* csr;
+    int num_levels;
+    CrpLevel levels[CRP_MAX_LEVELS + 1]; // levels[0] não é usado
+} CrpOverlay;
+
+// Agrupa os nós de cada célula em (offset, lista) segundo um critério de seleção
+void crp_group_by_cell(int n, int num_cells, const int cell[], const bool selected[],
+                       int** offset_out, int** nodes_out, int** index_out) {
+    int* offset = (int*)calloc(num_cells + 1, sizeof(int));
+    int* index = (int*)malloc(n * sizeof(int));
+    if (!offset || !index) {
+        perror("Erro ao alocar overlay CRP");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        index[v] = -1;
+        if (selected[v]) {
+            index[v] = offset[cell[v] + 1]++;
+        }
+    }
+    for (int c = 0; c < num_cells; c++) {
+        offset[c + 1] += offset[c];
+    }
+    int* nodes = (int*)malloc((offset[num_cells] + 1) * sizeof(int));
+    if (!nodes) {
+        perror("Erro ao alocar overlay CRP");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        if (index[v] != -1) {
+            nodes[offset[cell[v]] + index[v]] = v;
+        }
+    }
+    *offset_out = offset;
+    *nodes_out = nodes;
+    *index_out = index;
+}
+
+/**
+ * @brief Customização: recalcula as cliques de todas as células com os pesos atuais.
+ *
+ * No nível 1, cada clique vem de buscas no grafo original restritas à célula; nos
+ * níveis acima, as buscas usam as cliques do nível abaixo e as arestas entre suas
+ * células. Deve ser chamada após alterações de peso (ex.: update_edge_weight()).
+ *
+ * @param overlay O overlay criado por build_crp_overlay().
+ * @param graph O grafo (mesma topologia), de onde são lidos os pesos.
+ */
+void crp_customize(CrpOverlay* overlay, const Graph* graph) {
+    CsrGraph* csr = overlay->csr;
+    csr_refresh_weights(csr, graph);
+
+    for (int l = 1; l <= overlay->num_levels; l++) {
+        CrpLevel* level = &overlay->levels[l];
+        const CrpLevel* below = &overlay->levels[l - 1];
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < level->num_cells; c++) {
+            int num_search = level->search_offset[c + 1] - level->search_offset[c];
+            int num_boundary = level->boundary_offset[c + 1] - level->boundary_offset[c];
+            if (num_boundary == 0) continue;
+
+            const int* search_nodes = &level->search_nodes[level->search_offset[c]];
+            dist_t* dist = (dist_t*)malloc(num_search * sizeof(dist_t));
+            if (!dist) {
+                perror("Erro ao alocar customização CRP");
+                exit(EXIT_FAILURE);
+            }
+            MinHeap* heap = create_min_heap(num_search);
+
+            for (int i = 0; i < num_boundary; i++) {
+                int entry = level->boundary[level->boundary_offset[c] + i];
+                for (int k = 0; k < num_search; k++) {
+                    dist[k] = INFINITY;
+                }
+                dist[level->search_index[entry]] = 0;
+                heap_push_or_decrease(heap, level->search_index[entry], 0);
+
+                while (!is_empty_heap(heap)) {
+                    int local = heap_pop_min(heap);
+                    int u = search_nodes[local];
+
+                    // Arcos do grafo original: todos (nível 1) ou só os que cruzam células do nível abaixo
+                    for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+                        int v = csr->targets[e];
+                        if (level->cell[v] != c) continue;
+                        if (l > 1 && below->cell[v] == below->cell[u]) continue;
+                        int lv = level->search_index[v];
+                        dist_t candidate = dist_add(dist[local], csr->weights[e]);
+                        if (candidate < dist[lv]) {
+                            dist[lv] = candidate;
+                            heap_push_or_decrease(heap, lv, dist[lv]);
+                        }
+                    }
+
+                    // Arcos da clique da subcélula (níveis acima do 1)
+                    if (l > 1) {
+                        int sub = below->cell[u];
+                        int size = below->boundary_offset[sub + 1] - below->boundary_offset[sub];
+                        const dist_t* row = &below->clique[below->clique_offset[sub] + below->boundary_index[u] * size];
+                        for (int j = 0; j < size; j++) {
+                            int v = below->boundary[below->boundary_offset[sub] + j];
+                            int lv = level->search_index[v];
+                            dist_t candidate = dist_add(dist[local], row[j]);
+                            if (candidate < dist[lv]) {
+                                dist[lv] = candidate;
+                                heap_push_or_decrease(heap, lv, dist[lv]);
+                            }
+                        }
+                    }
+                }
+
+                dist_t* row = &level->clique[level->clique_offset[c] + i * num_boundary];
+                for (int j = 0; j < num_boundary; j++) {
+                    int exit_node = level->boundary[level->boundary_offset[c] + j];
+                    row[j] = dist[level->search_index[exit_node]];
+                }
+            }
+
+            free_min_heap(heap);
+            free(dist);
+        }
+    }
+}
+
+/**
+ * @brief Constrói a partição multinível e o overlay, e faz a primeira customização.
+ *
+ * O nível 1 vem de partition_graph(); cada nível acima agrupa CRP_FANOUT células
+ * consecutivas do nível abaixo, garantindo partições aninhadas.
+ *
+ * @param graph O grafo de transporte.
+ * @param num_levels Número de níveis (até CRP_MAX_LEVELS).
+ * @param num_cells Número de células do nível 1.
+ * @return O overlay customizado.
+ */
+CrpOverlay* build_crp_overlay(const Graph* graph, int num_levels, int num_cells) {
+    CrpOverlay* overlay = (CrpOverlay*)malloc(sizeof(CrpOverlay));
+    bool* selected = (bool*)malloc(graph->num_nodes * sizeof(bool));
+    if (!overlay || !selected) {
+        perror("Erro ao alocar overlay CRP");
+        exit(EXIT_FAILURE);
+    }
+    if (num_levels > CRP_MAX_LEVELS) num_levels = CRP_MAX_LEVELS;
+    if (num_levels < 1) num_levels = 1;
+
+    int n = graph->num_nodes;
+    CsrGraph* csr = build_csr(graph);
+    overlay->csr = csr;
+    overlay->num_levels = num_levels;
+
+    for (int l = 1; l <= num_levels; l++) {
+        CrpLevel* level = &overlay->levels[l];
+        level->cell = (int*)malloc(n * sizeof(int));
+        if (!level->cell) {
+            perror("Erro ao alocar overlay CRP");
+            exit(EXIT_FAILURE);
+        }
+        if (l == 1) {
+            level->num_cells = partition_graph(graph, num_cells, level->cell);
+        } else {
+            const CrpLevel* below = &overlay->levels[l - 1];
+            level->num_cells = (below->num_cells + CRP_FANOUT - 1) / CRP_FANOUT;
+            for (int v = 0; v < n; v++) {
+                level->cell[v] = below->cell[v] / CRP_FANOUT;
+            }
+        }
+
+        // Fronteira: nós com alguma aresta (de entrada ou saída) para outra célula
+        for (int v = 0; v < n; v++) {
+            selected[v] = false;
+        }
+        for (int u = 0; u < n; u++) {
+            for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+                int v = csr->targets[e];
+                if (level->cell[u] != level->cell[v]) {
+                    selected[u] = true;
+                    selected[v] = true;
+                }
+            }
+        }
+        crp_group_by_cell(n, level->num_cells, level->cell, selected,
+                          &level->boundary_offset, &level->boundary, &level->boundary_index);
+
+        // Nós de busca da customização: todos no nível 1, fronteiras do nível abaixo nos demais
+        for (int v = 0; v < n; v++) {
+            selected[v] = (l == 1) || overlay->levels[l - 1].boundary_index[v] != -1;
+        }
+        crp_group_by_cell(n, level->num_cells, level->cell, selected,
+                          &level->search_offset, &level->search_nodes, &level->search_index);
+
+        level->clique_offset = (int*)malloc((level->num_cells + 1) * sizeof(int));
+        if (!level->clique_offset) {
+            perror("Erro ao alocar overlay CRP");
+            exit(EXIT_FAILURE);
+        }
+        level->clique_offset[0] = 0;
+        for (int c = 0; c < level->num_cells; c++) {
+            int size = level->boundary_offset[c + 1] - level->boundary_offset[c];
+            level->clique_offset[c + 1] = level->clique_offset[c] + size * size;
+        }
+        level->clique = (dist_t*)malloc((level->clique_offset[level->num_cells] + 1) * sizeof(dist_t));
+        if (!level->clique) {
+            perror("Erro ao alocar overlay CRP");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(selected);
+    crp_customize(overlay, graph);
+    return overlay;
+}
+
+/**
+ * @brief Consulta de distância sobre o overlay.
+ *
+ * Cada nó é expandido no nível mais alto em que sua célula não contém a origem
+ * nem o destino: perto deles usa-se o grafo original; longe, as cliques das
+ * células e as arestas entre células daquele nível.
+ *
+ * @param overlay O overlay customizado.
+ * @param start_node O nó de partida.
+ * @param end_node O nó de chegada.
+ * @param settled Recebe o número de nós processados (pode ser NULL).
+ * @return A distância mínima, ou INFINITY se não houver caminho.
+ */
+dist_t crp_query(const CrpOverlay* overlay, int start_node, int end_node, int* settled) {
+    const CsrGraph* csr = overlay->csr;
+    int n = csr->num_nodes;
+    dist_t* dist = (dist_t*)malloc(n * sizeof(dist_t));
+    if (!dist) {
+        perror("Erro ao alocar consulta CRP");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        dist[v] = INFINITY;
+    }
+    MinHeap* heap = create_min_heap(n);
+    int count = 0;
+
+    dist[start_node] = 0;
+    heap_push_or_decrease(heap, start_node, 0);
+    while (!is_empty_heap(heap)) {
+        int u = heap_pop_min(heap);
+        count++;
+        if (u == end_node) break;
+
+        // Nível de expansão do nó
+        int l = overlay->num_levels;
+        while (l > 0) {
+            const CrpLevel* level = &overlay->levels[l];
+            if (level->cell[u] != level->cell[start_node] && level->cell[u] != level->cell[end_node]) {
+                break;
+            }
+            l--;
+        }
+
+        if (l == 0) {
+            for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+                int v = csr->targets[e];
+                dist_t candidate = dist_add(dist[u], csr->weights[e]);
+                if (candidate < dist[v]) {
+                    dist[v] = candidate;
+                    heap_push_or_decrease(heap, v, dist[v]);
+                }
+            }
+            continue;
+        }
+
+        const CrpLevel* level = &overlay->levels[l];
+        int c = level->cell[u];
+
+        // Atalhos da clique para as demais fronteiras da célula
+        int size = level->boundary_offset[c + 1] - level->boundary_offset[c];
+        const dist_t* row = &level->clique[level->clique_offset[c] + level->boundary_index[u] * size];
+        for (int j = 0; j < size; j++) {
+            int v = level->boundary[level->boundary_offset[c] + j];
+            dist_t candidate = dist_add(dist[u], row[j]);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                heap_push_or_decrease(heap, v, dist[v]);
+            }
+        }
+
+        // Arestas que deixam a célula
+        for (int e = csr->offsets[u]; e < csr->offsets[u + 1]; e++) {
+            int v = csr->targets[e];
+            dist_t candidate = dist_add(dist[u], csr->weights[e]);
+            if (level->cell[v] != c && candidate < dist[v]) {
+                dist[v] = candidate;
+                heap_push_or_decrease(heap, v, dist[v]);
+            }
+        }
+    }
+
+    dist_t result = dist[end_node];
+    if (settled) {
+        *settled = count;
+    }
+    free_min_heap(heap);
+    free(dist);
+    return result;
+}
+
+// Libera a memória do overlay
+void free_crp_overlay(CrpOverlay* overlay) {
+    if (!overlay) return;
+    for (int l = 1; l <= overlay->num_levels; l++) {
+        CrpLevel* level = &overlay->levels[l];
+        free(level->cell);
+        free(level->boundary_offset);
+        free(level->boundary);
+        free(level->boundary_index);
+        free(level->search_offset);
+        free(level->search_nodes);
+        free(level->search_index);
+        free(level->clique_offset);
+        free(level->clique);
+    }
+    free_csr(overlay->csr);
+    free(overlay);
+}
+
+// --- Rotulação por Hubs (Pruned Landmark Labeling) ---
+
+// Rótulos de hubs: cada nó v guarda pares (hub, distância) de saída (v -> hub) e
+// de entrada (hub -> v), tais que dist(s, t) = min sobre hubs comuns de
+// d(s, hub) + d(hub, t). Os rótulos ficam em arrays planos (hubs e distâncias
+// separados), ordenados pelo posto do hub e terminados por sentinela, para que a
+// consulta seja uma interseção por intercalação sem ramificações imprevisíveis.
+typedef struct HubLabels {
+    int num_nodes;
+    int* out_offset; // Início do rótulo de saída de cada nó (num_nodes + 1)
+    int* out_hubs;   // Posto do hub (crescente em cada rótulo, sentinela INT_MAX no fim)
+    dist_t* out_dists;
+    int* in_offset;  // Início do rótulo de entrada de cada nó (num_nodes + 1)
+    int* in_hubs;
+    dist_t* in_dists;
+    int* rank;       // Posto de cada nó na ordem de processamento
+} HubLabels;
+
+// Rótulo em construção (array dinâmico de pares)
+typedef struct LabelBuilder {
+    int size;
+    int capacity;
+    int* hubs;
+    dist_t* dists;
+} LabelBuilder;
+
+void label_append(LabelBuilder* label, int hub, dist_t dist) {
+    if (label->size == label->capacity) {
+        label->capacity = label->capacity ? label->capacity * 2 : 4;
+        label->hubs = (int*)realloc(label->hubs, label->capacity * sizeof(int));
+        label->dists = (dist_t*)realloc(label->dists, label->capacity * sizeof(dist_t));
+        if (!label->hubs || !label->dists) {
+            perror("Erro ao realocar rótulo de hubs");
+            exit(EXIT_FAILURE);
+        }
+    }
+    label->hubs[label->size] = hub;
+    label->dists[label->size] = dist;
+    label->size++;
+}
+
+// Distância pelos rótulos em construção; os hubs de origem estão marcados em hub_dist
+dist_t label_query_partial(const LabelBuilder* label, const dist_t hub_dist[]) {
+    dist_t best = INFINITY;
+    for (int i = 0; i < label->size; i++) {
+        dist_t d = dist_add(hub_dist[label->hubs[i]], label->dists[i]);
+        if (d < best) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+// Compacta os rótulos em arrays planos com sentinela
+void flatten_labels(int n, LabelBuilder labels[], int** offset_out, int** hubs_out, dist_t** dists_out) {
+    int* offset = (int*)malloc((n + 1) * sizeof(int));
+    if (!offset) {
+        perror("Erro ao alocar rótulos de hubs");
+        exit(EXIT_FAILURE);
+    }
+    offset[0] = 0;
+    for (int v = 0; v < n; v++) {
+        offset[v + 1] = offset[v] + labels[v].size + 1;
+    }
+    int* hubs = (int*)malloc(offset[n] * sizeof(int));
+    dist_t* dists = (dist_t*)malloc(offset[n] * sizeof(dist_t));
+    if (!hubs || !dists) {
+        perror("Erro ao alocar rótulos de hubs");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        memcpy(&hubs[offset[v]], labels[v].hubs, labels[v].size * sizeof(int));
+        memcpy(&dists[offset[v]], labels[v].dists, labels[v].size * sizeof(dist_t));
+        hubs[offset[v + 1] - 1] = INT_MAX; // Sentinela
+        dists[offset[v + 1] - 1] = INFINITY;
+        free(labels[v].hubs);
+        free(labels[v].dists);
+    }
+    *offset_out = offset;
+    *hubs_out = hubs;
+    *dists_out = dists;
+}
+
+// Ordena nós por grau total decrescente (hubs importantes primeiro)
+int compare_by_degree_desc(const void* a, const void* b) {
+    const int* da = (const int*)a;
+    const int* db = (const int*)b;
+    if (da[1] != db[1]) return (db[1] > da[1]) - (db[1] < da[1]);
+    return (da[0] > db[0]) - (da[0] < db[0]);
+}
+
+/**
+ * @brief Constrói os rótulos de hubs com Pruned Landmark Labeling.
+ *
+ * Os nós são processados em ordem decrescente de grau. Para cada hub h, uma busca
+ * direta acrescenta (h, d) ao rótulo de entrada dos nós alcançados e uma busca
+ * reversa ao rótulo de saída; um nó é podado quando os rótulos já construídos
+ * fornecem uma distância não maior que a da busca.
+ *
+ * @param graph O grafo de transporte.
+ * @return Os rótulos compactados.
+ */
+HubLabels* build_hub_labels(const Graph* graph) {
+    int n = graph->num_nodes;
+    HubLabels* labels = (HubLabels*)malloc(sizeof(HubLabels));
+    LabelBuilder* out_labels = (LabelBuilder*)calloc(n, sizeof(LabelBuilder));
+    LabelBuilder* in_labels = (LabelBuilder*)calloc(n, sizeof(LabelBuilder));
+    int* order = (int*)malloc(2 * n * sizeof(int));
+    dist_t* dist = (dist_t*)malloc(n * sizeof(dist_t));
+    dist_t* hub_dist = (dist_t*)malloc(n * sizeof(dist_t)); // Rótulo do hub atual indexado pelo posto
+    int* touched = (int*)malloc(n * sizeof(int));
+    if (!labels || !out_labels || !in_labels || !order || !dist || !hub_dist || !touched) {
+        perror("Erro ao alocar rótulos de hubs");
+        exit(EXIT_FAILURE);
+    }
+    labels->num_nodes = n;
+    labels->rank = (int*)malloc(n * sizeof(int));
+    if (!labels->rank) {
+        perror("Erro ao alocar rótulos de hubs");
+        exit(EXIT_FAILURE);
+    }
+
+    Graph* reverse = create_reverse_graph(graph);
+    for (int v = 0; v < n; v++) {
+        int degree = 0;
+        for (AdjListNode* current = graph->adj_lists[v]; current; current = current->next) degree++;
+        for (AdjListNode* current = reverse->adj_lists[v]; current; current = current->next) degree++;
+        order[2 * v] = v;
+        order[2 * v + 1] = degree;
+    }
+    qsort(order, n, 2 * sizeof(int), compare_by_degree_desc);
+    for (int r = 0; r < n; r++) {
+        labels->rank[order[2 * r]] = r;
+    }
+
+    for (int v = 0; v < n; v++) {
+        dist[v] = INFINITY;
+        hub_dist[v] = INFINITY;
+    }
+    MinHeap* heap = create_min_heap(n);
+
+    for (int r = 0; r < n; r++) {
+        int hub = order[2 * r];
+
+        // pass 0: busca direta (rótulos de entrada); pass 1: busca reversa (rótulos de saída)
+        for (int pass = 0; pass < 2; pass++) {
+            const Graph* search = pass == 0 ? graph : reverse;
+            LabelBuilder* hub_side = pass == 0 ? &out_labels[hub] : &in_labels[hub];
+            LabelBuilder* targets = pass == 0 ? in_labels : out_labels;
+
+            // Marca as distâncias do rótulo do hub, usadas na poda
+            for (int i = 0; i < hub_side->size; i++) {
+                hub_dist[hub_side->hubs[i]] = hub_side->dists[i];
+            }
+            hub_dist[r] = 0;
+
+            int num_touched = 0;
+            dist[hub] = 0;
+            touched[num_touched++] = hub;
+            heap_push_or_decrease(heap, hub, 0);
+            while (!is_empty_heap(heap)) {
+                int u = heap_pop_min(heap);
+                if (label_query_partial(&targets[u], hub_dist) <= dist[u]) {
+                    continue; // Poda: distância já coberta por hubs mais importantes
+                }
+                label_append(&targets[u], r, dist[u]);
+                for (AdjListNode* current = search->adj_lists[u]; current; current = current->next) {
+                    int v = current->dest;
+                    dist_t candidate = dist_add(dist[u], current->weight);
+                    if (labels->rank[v] > r && candidate < dist[v]) {
+                        if (dist[v] == INFINITY) {
+                            touched[num_touched++] = v;
+                        }
+                        dist[v] = candidate;
+                        heap_push_or_decrease(heap, v, dist[v]);
+                    }
+                }
+            }
+
+            for (int i = 0; i < num_touched; i++) {
+                dist[touched[i]] = INFINITY;
+            }
+            for (int i = 0; i < hub_side->size; i++) {
+                hub_dist[hub_side->hubs[i]] = INFINITY;
+            }
+            hub_dist[r] = INFINITY;
+        }
+    }
+
+    flatten_labels(n, out_labels, &labels->out_offset, &labels->out_hubs, &labels->out_dists);
+    flatten_labels(n, in_labels, &labels->in_offset, &labels->in_hubs, &labels->in_dists);
+
+    free_min_heap(heap);
+    free_graph(reverse);
+    free(out_labels);
+    free(in_labels);
+    free(order);
+    free(dist);
+    free(hub_dist);
+    free(touched);
+    return labels;
+}
+
+/**
+ * @brief Distância entre dois nós pela interseção dos rótulos.
+ *
+ * @param labels Os rótulos de hubs.
+ * @param start_node O nó de partida.
+ * @param end_node O nó de chegada.
+ * @return A distância mínima, ou INFINITY se não houver caminho.
+ */
+dist_t hub_label_distance(const HubLabels* labels, int start_node, int end_node) {
+    const int* out_hubs = &labels->out_hubs[labels->out_offset[start_node]];
+    const dist_t* out_dists = &labels->out_dists[labels->out_offset[start_node]];
+    const int* in_hubs = &labels->in_hubs[labels->in_offset[end_node]];
+    const dist_t* in_dists = &labels->in_dists[labels->in_offset[end_node]];
+
+    // Intercalação: as sentinelas (INT_MAX) encerram o laço sem testar limites
+    dist_t best = INFINITY;
+    int i = 0, j = 0;
+    while (out_hubs[i] != INT_MAX || in_hubs[j] != INT_MAX) {
+        int a = out_hubs[i];
+        int b = in_hubs[j];
+        if (a == b) {
+            dist_t d = dist_add(out_dists[i], in_dists[j]);
+            best = d < best ? d : best;
+        }
+        i += (a <= b);
+        j += (b <= a);
+    }
+    return best;
+}
+
+// Libera a memória dos rótulos
+void free_hub_labels(HubLabels* labels) {
+    if (!labels) return;
+    free(labels->out_offset);
+    free(labels->out_hubs);
+    free(labels->out_dists);
+    free(labels->in_offset);
+    free(labels->in_hubs);
+    free(labels->in_dists);
+    free(labels->rank);
+    free(labels);
+}
+
+// --- Tabela de Distâncias (Um-para-Muitos e Muitos-para-Muitos) ---
+
+/**
+ * @brief Dijkstra de uma origem que para assim que todos os destinos são fixados.
+ *
+ * @param graph O grafo de transporte.
+ * @param source O nó de origem.
+ * @param targets Os nós de destino (podem se repetir).
+ * @param num_targets O número de destinos.
+ * @param row Saída: row[j] é a distância de source a targets[j] (INFINITY se inalcançável).
+ * @return O número de nós processados.
+ */
+int dijkstra_one_to_many(const Graph* graph, int source, const int targets[], int num_targets, dist_t row[]) {
+    int n = graph->num_nodes;
+    dist_t* dist = (dist_t*)malloc(n * sizeof(dist_t));
+    bool* is_target = (bool*)calloc(n, sizeof(bool));
+    if (!dist || !is_target) {
+        perror("Erro ao alocar busca um-para-muitos");
+        exit(EXIT_FAILURE);
+    }
+    int remaining = 0;
+    for (int j = 0; j < num_targets; j++) {
+        if (!is_target[targets[j]]) {
+            is_target[targets[j]] = true;
+            remaining++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        dist[v] = INFINITY;
+    }
+
+    MinHeap* heap = create_min_heap(n);
+    int settled = 0;
+    dist[source] = 0;
+    heap_push_or_decrease(heap, source, 0);
+    while (!is_empty_heap(heap) && remaining > 0) {
+        int u = heap_pop_min(heap);
+        settled++;
+        if (is_target[u]) {
+            remaining--;
+        }
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            int v = current->dest;
+            dist_t candidate = dist_add(dist[u], current->weight);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                heap_push_or_decrease(heap, v, candidate);
+            }
+        }
+    }
+
+    for (int j = 0; j < num_targets; j++) {
+        row[j] = dist[targets[j]];
+    }
+    free_min_heap(heap);
+    free(dist);
+    free(is_target);
+    return settled;
+}
+
+/**
+ * @brief Tabela de distâncias origens × destinos pelos rótulos de hubs (buckets).
+ *
+ * Os rótulos de entrada dos destinos são distribuídos em buckets indexados pelo
+ * posto do hub (contagem + somas de prefixo, sem listas encadeadas). Cada origem
+ * percorre então seu rótulo de saída e relaxa, para cada hub, todas as entradas
+ * do bucket correspondente. As linhas da tabela são independentes e calculadas
+ * em paralelo quando compilado com OpenMP.
+ *
+ * @param labels Os rótulos de hubs.
+ * @param sources Os nós de origem.
+ * @param num_sources O número de origens.
+ * @param targets Os nós de destino.
+ * @param num_targets O número de destinos.
+ * @param table Saída densa em ordem de linhas: table[i * num_targets + j] = dist(sources[i], targets[j]).
+ */
+void hub_label_table(const HubLabels* labels, const int sources[], int num_sources,
+                     const int targets[], int num_targets, dist_t table[]) {
+    int n = labels->num_nodes;
+    int* bucket_offset = (int*)calloc(n + 1, sizeof(int));
+    if (!bucket_offset) {
+        perror("Erro ao alocar buckets da tabela de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    for (int j = 0; j < num_targets; j++) {
+        for (int k = labels->in_offset[targets[j]]; labels->in_hubs[k] != INT_MAX; k++) {
+            bucket_offset[labels->in_hubs[k] + 1]++;
+        }
+    }
+    for (int h = 0; h < n; h++) {
+        bucket_offset[h + 1] += bucket_offset[h];
+    }
+
+    int num_entries = bucket_offset[n];
+    int* bucket_column = (int*)malloc((num_entries + 1) * sizeof(int));
+    dist_t* bucket_dist = (dist_t*)malloc((num_entries + 1) * sizeof(dist_t));
+    int* fill = (int*)malloc(n * sizeof(int));
+    if (!bucket_column || !bucket_dist || !fill) {
+        perror("Erro ao alocar buckets da tabela de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(fill, bucket_offset, n * sizeof(int));
+    for (int j = 0; j < num_targets; j++) {
+        for (int k = labels->in_offset[targets[j]]; labels->in_hubs[k] != INT_MAX; k++) {
+            int slot = fill[labels->in_hubs[k]]++;
+            bucket_column[slot] = j;
+            bucket_dist[slot] = labels->in_dists[k];
+        }
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < num_sources; i++) {
+        dist_t* row = &table[(size_t)i * num_targets];
+        for (int j = 0; j < num_targets; j++) {
+            row[j] = INFINITY;
+        }
+        for (int k = labels->out_offset[sources[i]]; labels->out_hubs[k] != INT_MAX; k++) {
+            int hub = labels->out_hubs[k];
+            dist_t to_hub = labels->out_dists[k];
+            for (int e = bucket_offset[hub]; e < bucket_offset[hub + 1]; e++) {
+                dist_t d = dist_add(to_hub, bucket_dist[e]);
+                if (d < row[bucket_column[e]]) {
+                    row[bucket_column[e]] = d;
+                }
+            }
+        }
+    }
+
+    free(bucket_offset);
+    free(bucket_column);
+    free(bucket_dist);
+    free(fill);
+}
+
+/**
+ * @brief Tabela de distâncias origens × destinos sem pré-processamento.
+ *
+ * Uma busca um-para-muitos por origem, com parada antecipada; útil quando o
+ * grafo muda com frequência e reconstruir os rótulos não compensa.
+ *
+ * @param graph O grafo de transporte.
+ * @param sources Os nós de origem.
+ * @param num_sources O número de origens.
+ * @param targets Os nós de destino.
+ * @param num_targets O número de destinos.
+ * @param table Saída densa em ordem de linhas (num_sources × num_targets).
+ */
+void dijkstra_table(const Graph* graph, const int sources[], int num_sources,
+                    const int targets[], int num_targets, dist_t table[]) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < num_sources; i++) {
+        dijkstra_one_to_many(graph, sources[i], targets, num_targets, &table[(size_t)i * num_targets]);
+    }
+}
+
+// Imprime uma tabela de distâncias (linhas: origens; colunas: destinos por número)
+void print_distance_table(const Graph* graph, const int sources[], int num_sources,
+                          const int targets[], int num_targets, const dist_t table[]) {
+    char text[32];
+    printf("%-18s", "");
+    for (int j = 0; j < num_targets; j++) {
+        printf(" %5d", targets[j]);
+    }
+    printf("\n");
+    for (int i = 0; i < num_sources; i++) {
+        printf("%-18.18s", graph->node_names[sources[i]]);
+        for (int j = 0; j < num_targets; j++) {
+            printf(" %5s", format_distance(table[(size_t)i * num_targets + j], text, sizeof(text)));
+        }
+        printf("\n");
+    }
+}
+
+// --- Quadro de Horários e Connection Scan (CSA) ---
+
+// Estrutura para uma conexão elementar do quadro de horários: um veículo
+// partindo de uma estação e chegando à seguinte sem paradas intermediárias.
+typedef struct Connection {
+    int dep_station; // Estação de partida
+    int arr_station; // Estação de chegada
+    int dep_time;    // Horário de partida (minutos desde 00:00)
+    int arr_time;    // Horário de chegada (minutos desde 00:00)
+    int trip_id;     // Viagem (veículo) à qual a conexão pertence
+} Connection;
+
+// Quadro de horários em formato compacto: um único array contíguo de conexões,
+// ordenado por horário de partida, que o CSA percorre sequencialmente.
+typedef struct Timetable {
+    int num_stations;
+    int num_trips;
+    int num_connections;
+    int capacity;
+    Connection* connections;
+    char** node_names; // Nomes das estações (compartilhados com o grafo)
+} Timetable;
+
+// Cria um quadro de horários vazio para as mesmas estações do grafo
+Timetable* create_timetable(Graph* graph) {
+    Timetable* tt = (Timetable*)malloc(sizeof(Timetable));
+    if (!tt) {
+        perror("Erro ao alocar quadro de horários");
+        exit(EXIT_FAILURE);
+    }
+    tt->num_stations = graph->num_nodes;
+    tt->num_trips = 0;
+    tt->num_connections = 0;
+    tt->capacity = 64;
+    tt->connections = (Connection*)malloc(tt->capacity * sizeof(Connection));
+    if (!tt->connections) {
+        perror("Erro ao alocar conexões");
+        free(tt);
+        exit(EXIT_FAILURE);
+    }
+    tt->node_names = graph->node_names;
+    return tt;
+}
+
+// Adiciona uma conexão ao quadro (a ordenação é feita por sort_timetable())
+void add_connection(Timetable* tt, int dep_station, int arr_station,
+                    int dep_time, int arr_time, int trip_id) {
+    if (dep_station < 0 || dep_station >= tt->num_stations ||
+        arr_station < 0 || arr_station >= tt->num_stations ||
+        arr_time < dep_time || trip_id < 0) {
+        fprintf(stderr, "Erro: conexão inválida.\n");
+        return;
+    }
+    if (tt->num_connections == tt->capacity) {
+        int new_capacity = tt->capacity * 2;
+        Connection* grown = (Connection*)realloc(tt->connections, new_capacity * sizeof(Connection));
+        if (!grown) {
+            perror("Erro ao realocar conexões");
+            exit(EXIT_FAILURE);
+        }
+        tt->connections = grown;
+        tt->capacity = new_capacity;
+    }
+    Connection* c = &tt->connections[tt->num_connections++];
+    c->dep_station = dep_station;
+    c->arr_station = arr_station;
+    c->dep_time = dep_time;
+    c->arr_time = arr_time;
+    c->trip_id = trip_id;
+    if (trip_id >= tt->num_trips) {
+        tt->num_trips = trip_id + 1;
+    }
+}
+
+// Adiciona uma viagem completa: 'stops' visitadas em sequência, com 'travel_times[i]'
+// minutos entre stops[i] e stops[i + 1]. Retorna o identificador da viagem criada.
+int add_trip(Timetable* tt, const int stops[], const int travel_times[], int num_stops, int first_departure) {
+    int trip_id = tt->num_trips;
+    int time = first_departure;
+    for (int i = 0; i + 1 < num_stops; i++) {
+        add_connection(tt, stops[i], stops[i + 1], time, time + travel_times[i], trip_id);
+        time += travel_times[i];
+    }
+    tt->num_trips = trip_id + 1;
+    return trip_id;
+}
+
+// Critério de ordenação das conexões: horário de partida, depois de chegada
+int compare_connections(const void* a, const void* b) {
+    const Connection* ca = (const Connection*)a;
+    const Connection* cb = (const Connection*)b;
+    if (ca->dep_time != cb->dep_time) {
+        return (ca->dep_time > cb->dep_time) - (ca->dep_time < cb->dep_time);
+    }
+    return (ca->arr_time > cb->arr_time) - (ca->arr_time < cb->arr_time);
+}
+
+// Ordena as conexões por horário de partida (requisito do CSA)
+void sort_timetable(Timetable* tt) {
+    qsort(tt->connections, tt->num_connections, sizeof(Connection), compare_connections);
+}
+
+/**
+ * @brief Carrega conexões de um arquivo texto para o quadro de horários.
+ *
+ * Cada linha tem o formato "origem destino HH:MM HH:MM viagem", com índices de
+ * estação iguais aos do grafo. Linhas vazias ou iniciadas por '#' são ignoradas.
+ *
+ * @param tt O quadro de horários a preencher.
+ * @param filename Caminho do arquivo.
+ * @return Número de conexões lidas, ou -1 se o arquivo não pôde ser aberto.
+ */
+int load_timetable(Timetable* tt, const char* filename) {
+    FILE* file = fopen(filename, "r");
+    if (!file) {
+        perror("Erro ao abrir quadro de horários");
+        return -1;
+    }
+
+    char line[256];
+    int line_number = 0;
+    int loaded = 0;
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+            continue;
+        }
+        int src, dst, dep_h, dep_m, arr_h, arr_m, trip;
+        if (sscanf(line, "%d %d %d:%d %d:%d %d", &src, &dst, &dep_h, &dep_m, &arr_h, &arr_m, &trip) != 7) {
+            fprintf(stderr, "Aviso: linha %d do quadro de horários ignorada.\n", line_number);
+            continue;
+        }
+        int before = tt->num_connections;
+        add_connection(tt, src, dst, dep_h * 60 + dep_m, arr_h * 60 + arr_m, trip);
+        loaded += tt->num_connections - before;
+    }
+    fclose(file);
+
+    sort_timetable(tt);
+    return loaded;
+}
+
+// Libera a memória do quadro de horários (os nomes pertencem ao grafo)
+void free_timetable(Timetable* tt) {
+    if (!tt) return;
+    free(tt->connections);
+    free(tt);
+}
+
+/**
+ * @brief Connection Scan Algorithm: horário mais cedo de chegada a partir de um
+ * horário de partida, percorrendo uma única vez o array ordenado de conexões.
+ *
+ * @param tt O quadro de horários (já ordenado).
+ * @param start_station Estação de partida.
+ * @param end_station Estação de destino.
+ * @param departure_time Horário a partir do qual o passageiro está na origem.
+ * @param arrival Array (num_stations) com o horário mais cedo de chegada a cada estação.
+ * @param in_connection Array (num_stations) com a conexão pela qual se chega a cada estação.
+ * @param boarded_at Array (num_trips) com a conexão em que cada viagem foi embarcada.
+ * @return Horário de chegada ao destino, ou TIME_INFINITY se inalcançável.
+ */
+int csa_earliest_arrival(const Timetable* tt, int start_station, int end_station, int departure_time,
+                         int arrival[], int in_connection[], int boarded_at[]) {
+    for (int i = 0; i < tt->num_stations; i++) {
+        arrival[i] = TIME_INFINITY;
+        in_connection[i] = -1;
+    }
+    for (int i = 0; i < tt->num_trips; i++) {
+        boarded_at[i] = -1; // -1 indica viagem ainda não alcançada
+    }
+    arrival[start_station] = departure_time;
+
+    // Busca binária pela primeira conexão que parte a partir do horário desejado
+    int lo = 0, hi = tt->num_connections;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (tt->connections[mid].dep_time < departure_time) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (int i = lo; i < tt->num_connections; i++) {
+        const Connection* c = &tt->connections[i];
+
+        // Nenhuma conexão posterior pode melhorar a chegada ao destino
+        if (c->dep_time >= arrival[end_station]) {
+            break;
+        }
+
+        // A conexão é utilizável se o passageiro já está no veículo ou na estação a tempo
+        if (boarded_at[c->trip_id] != -1 || arrival[c->dep_station] <= c->dep_time) {
+            if (boarded_at[c->trip_id] == -1) {
+                boarded_at[c->trip_id] = i;
+            }
+            if (c->arr_time < arrival[c->arr_station]) {
+                arrival[c->arr_station] = c->arr_time;
+                in_connection[c->arr_station] = i;
+            }
+        }
+    }
+    return arrival[end_station];
+}
+
+// Imprime a jornada encontrada pelo CSA, agrupando conexões consecutivas da mesma viagem
+void print_csa_journey(const Timetable* tt, const int in_connection[], const int boarded_at[],
+                       int start_station, int end_station) {
+    if (end_station == start_station) {
+        printf("Você já está em '%s'.\n", tt->node_names[start_station]);
+        return;
+    }
+    if (in_connection[end_station] == -1) {
+        printf("Não há conexão disponível de '%s' para '%s' neste horário.\n",
+               tt->node_names[start_station], tt->node_names[end_station]);
+        return;
+    }
+
+    // Constrói a lista de trechos (embarque, desembarque) de trás para frente
+    int legs_board[MAX_NODES];
+    int legs_alight[MAX_NODES];
+    int num_legs = 0;
+    int station = end_station;
+
+    while (station != start_station && num_legs < MAX_NODES) {
+        int alight = in_connection[station];
+        int board = boarded_at[tt->connections[alight].trip_id];
+        legs_board[num_legs] = board;
+        legs_alight[num_legs] = alight;
+        num_legs++;
+        station = tt->connections[board].dep_station;
+    }
+
+    printf("Itinerário:\n");
+    for (int i = num_legs - 1; i >= 0; i--) {
+        const Connection* board = &tt->connections[legs_board[i]];
+        const Connection* alight = &tt->connections[legs_alight[i]];
+        printf("  Viagem %d: %s (%02d:%02d) -> %s (%02d:%02d)\n", board->trip_id,
+               tt->node_names[board->dep_station], board->dep_time / 60, board->dep_time % 60,
+               tt->node_names[alight->arr_station], alight->arr_time / 60, alight->arr_time % 60);
+    }
+}
+
+// --- RAPTOR: Roteamento por Rodadas (chegada x transferências) ---
+
+#define RAPTOR_MAX_ROUNDS 6 // Número máximo de viagens (transferências + 1) por jornada
+
+// Rotas e viagens dispostas em arrays contíguos: as paradas de uma rota ficam em
+// sequência e os horários de cada viagem ocupam uma linha de 'num_stops' posições,
+// de modo que a varredura de uma rota percorre a memória linearmente.
+typedef struct RaptorData {
+    int num_stations;
+    int num_routes;
+    int* route_stop_offset;    // Início das paradas de cada rota em route_stops (num_routes + 1)
+    int* route_stops;          // Estações de cada rota, na ordem de passagem
+    int* route_trip_offset;    // Início das viagens de cada rota (num_routes + 1)
+    int* route_time_offset;    // Início dos horários de cada rota em arr_times/dep_times
+    int* trip_ids;             // Identificador da viagem no quadro de horários
+    int* arr_times;            // Horários de chegada (uma linha por viagem)
+    int* dep_times;            // Horários de partida (uma linha por viagem)
+    int* station_route_offset; // Início das rotas de cada estação (num_stations + 1)
+    int* station_routes;       // Pares (rota, posição da estação na rota)
+    char** node_names;         // Nomes das estações (compartilhados com o grafo)
+} RaptorData;
+
+// Um trecho percorrido dentro de um único veículo
+typedef struct RaptorLeg {
+    int trip_id;
+    int from_station;
+    int to_station;
+    int dep_time;
+    int arr_time;
+} RaptorLeg;
+
+// Uma jornada do conjunto de Pareto (chegada, transferências)
+typedef struct RaptorJourney {
+    int arrival_time;
+    int num_transfers;
+    int num_legs;
+    RaptorLeg legs[RAPTOR_MAX_ROUNDS];
+} RaptorJourney;
+
+// Viagem auxiliar usada na construção das rotas
+typedef struct RaptorTripKey {
+    int route;
+    int first_dep;
+    int trip_id;
+    int first_conn; // Primeira conexão da viagem no array ordenado por viagem
+} RaptorTripKey;
+
+int compare_connections_by_trip(const void* a, const void* b) {
+    const Connection* ca = (const Connection*)a;
+    const Connection* cb = (const Connection*)b;
+    if (ca->trip_id != cb->trip_id) {
+        return (ca->trip_id > cb->trip_id) - (ca->trip_id < cb->trip_id);
+    }
+    return (ca->dep_time > cb->dep_time) - (ca->dep_time < cb->dep_time);
+}
+
+int compare_trip_keys(const void* a, const void* b) {
+    const RaptorTripKey* ka = (const RaptorTripKey*)a;
+    const RaptorTripKey* kb = (const RaptorTripKey*)b;
+    if (ka->route != kb->route) {
+        return (ka->route > kb->route) - (ka->route < kb->route);
+    }
+    return (ka->first_dep > kb->first_dep) - (ka->first_dep < kb->first_dep);
+}
+
+// Verifica se 'later' nunca parte nem chega antes de 'earlier' em nenhuma parada
+// (ambas com 'length' conexões sobre a mesma sequência de paradas)
+bool raptor_trip_follows(const Connection* earlier, const Connection* later, int length) {
+    for (int k = 0; k < length; k++) {
+        if (later[k].dep_time < earlier[k].dep_time || later[k].arr_time < earlier[k].arr_time) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Aloca um array de inteiros ou encerra o programa
+int* raptor_alloc(int count) {
+    int* array = (int*)malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!array) {
+        perror("Erro ao alocar estruturas do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+    return array;
+}
+
+/**
+ * @brief Constrói as rotas do RAPTOR a partir do quadro de horários.
+ *
+ * Viagens com a mesma sequência de paradas formam uma rota; dentro de cada rota
+ * as viagens são ordenadas pela partida na primeira parada. A busca binária da
+ * consulta exige que nenhuma viagem ultrapasse outra da mesma rota, então uma
+ * viagem que parte depois mas chega antes em alguma parada (ou o contrário) vai
+ * para uma rota separada com a mesma sequência de paradas. Viagens cujas
+ * conexões não formam uma sequência contínua são descartadas.
+ *
+ * @param tt O quadro de horários.
+ * @return Estrutura pronta para consultas.
+ */
+RaptorData* build_raptor_data(const Timetable* tt) {
+    int n = tt->num_connections;
+    Connection* by_trip = (Connection*)malloc((n > 0 ? n : 1) * sizeof(Connection));
+    RaptorTripKey* keys = (RaptorTripKey*)malloc((tt->num_trips > 0 ? tt->num_trips : 1) * sizeof(RaptorTripKey));
+    if (!by_trip || !keys) {
+        perror("Erro ao alocar estruturas do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(by_trip, tt->connections, n * sizeof(Connection));
+    qsort(by_trip, n, sizeof(Connection), compare_connections_by_trip);
+
+    // Assinatura (hash) e representante de cada rota já encontrada
+    unsigned int* route_hash = (unsigned int*)malloc((tt->num_trips > 0 ? tt->num_trips : 1) * sizeof(unsigned int));
+    int* route_first_conn = raptor_alloc(tt->num_trips);
+    int* route_length = raptor_alloc(tt->num_trips);
+    if (!route_hash) {
+        perror("Erro ao alocar estruturas do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+
+    int num_keys = 0;
+    int num_routes = 0;
+    int total_stops = 0;
+    int total_times = 0;
+
+    for (int i = 0; i < n;) {
+        int j = i;
+        bool chained = true;
+        while (j + 1 < n && by_trip[j + 1].trip_id == by_trip[i].trip_id) {
+            if (by_trip[j + 1].dep_station != by_trip[j].arr_station ||
+                by_trip[j + 1].dep_time < by_trip[j].arr_time) {
+                chained = false;
+            }
+            j++;
+        }
+        int length = j - i + 1; // Número de conexões (paradas - 1)
+
+        if (!chained) {
+            fprintf(stderr, "Aviso: viagem %d descontínua ignorada pelo RAPTOR.\n", by_trip[i].trip_id);
+            i = j + 1;
+            continue;
+        }
+
+        // Assinatura FNV-1a da sequência de paradas
+        unsigned int hash = 2166136261u;
+        hash = (hash ^ (unsigned int)by_trip[i].dep_station) * 16777619u;
+        for (int k = i; k <= j; k++) {
+            hash = (hash ^ (unsigned int)by_trip[k].arr_station) * 16777619u;
+        }
+
+        int route = -1;
+        for (int r = 0; r < num_routes && route == -1; r++) {
+            if (route_hash[r] != hash || route_length[r] != length) {
+                continue;
+            }
+            const Connection* other = &by_trip[route_first_conn[r]];
+            bool same = other->dep_station == by_trip[i].dep_station;
+            for (int k = 0; same && k < length; k++) {
+                same = other[k].arr_station == by_trip[i + k].arr_station;
+            }
+            if (same) {
+                route = r;
+            }
+        }
+        if (route == -1) {
+            route = num_routes++;
+            route_hash[route] = hash;
+            route_first_conn[route] = i;
+            route_length[route] = length;
+        }
+        total_times += length + 1;
+
+        keys[num_keys].route = route;
+        keys[num_keys].first_dep = by_trip[i].dep_time;
+        keys[num_keys].trip_id = by_trip[i].trip_id;
+        keys[num_keys].first_conn = i;
+        num_keys++;
+        i = j + 1;
+    }
+    qsort(keys, num_keys, sizeof(RaptorTripKey), compare_trip_keys);
+
+    // Separa ultrapassagens: em ordem de partida, cada viagem entra na primeira
+    // rota da mesma sequência cuja última viagem ela segue em todas as paradas
+    int* split_first_conn = raptor_alloc(num_keys);
+    int* split_length = raptor_alloc(num_keys);
+    int* split_last = raptor_alloc(num_keys); // Última viagem (conexão inicial) de cada rota
+    int num_split = 0;
+    for (int g = 0; g < num_keys;) {
+        int pattern = keys[g].route;
+        int first_split = num_split;
+        for (; g < num_keys && keys[g].route == pattern; g++) {
+            const Connection* trip = &by_trip[keys[g].first_conn];
+            int route = first_split;
+            while (route < num_split &&
+                   !raptor_trip_follows(&by_trip[split_last[route]], trip, route_length[pattern])) {
+                route++;
+            }
+            if (route == num_split) {
+                num_split++;
+                split_first_conn[route] = route_first_conn[pattern];
+                split_length[route] = route_length[pattern];
+                total_stops += route_length[pattern] + 1;
+            }
+            split_last[route] = keys[g].first_conn;
+            keys[g].route = route;
+        }
+    }
+    free(route_first_conn);
+    free(route_length);
+    free(split_last);
+    route_first_conn = split_first_conn;
+    route_length = split_length;
+    num_routes = num_split;
+    qsort(keys, num_keys, sizeof(RaptorTripKey), compare_trip_keys);
+
+    RaptorData* data = (RaptorData*)malloc(sizeof(RaptorData));
+    if (!data) {
+        perror("Erro ao alocar estruturas do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+    data->num_stations = tt->num_stations;
+    data->num_routes = num_routes;
+    data->node_names = tt->node_names;
+    data->route_stop_offset = raptor_alloc(num_routes + 1);
+    data->route_stops = raptor_alloc(total_stops);
+    data->route_trip_offset = raptor_alloc(num_routes + 1);
+    data->route_time_offset = raptor_alloc(num_routes);
+    data->trip_ids = raptor_alloc(num_keys);
+    data->arr_times = raptor_alloc(total_times);
+    data->dep_times = raptor_alloc(total_times);
+
+    // Paradas de cada rota
+    int offset = 0;
+    for (int r = 0; r < num_routes; r++) {
+        const Connection* first = &by_trip[route_first_conn[r]];
+        data->route_stop_offset[r] = offset;
+        data->route_stops[offset++] = first->dep_station;
+        for (int k = 0; k < route_length[r]; k++) {
+            data->route_stops[offset++] = first[k].arr_station;
+        }
+    }
+    data->route_stop_offset[num_routes] = offset;
+
+    // Viagens (já agrupadas por rota e ordenadas por partida) e seus horários
+    int time_offset = 0;
+    int key = 0;
+    for (int r = 0; r < num_routes; r++) {
+        int num_stops = route_length[r] + 1;
+        data->route_trip_offset[r] = key;
+        data->route_time_offset[r] = time_offset;
+        for (; key < num_keys && keys[key].route == r; key++) {
+            const Connection* c = &by_trip[keys[key].first_conn];
+            int* arr = &data->arr_times[time_offset];
+            int* dep = &data->dep_times[time_offset];
+            data->trip_ids[key] = keys[key].trip_id;
+            arr[0] = c[0].dep_time;
+            for (int k = 0; k < num_stops - 1; k++) {
+                dep[k] = c[k].dep_time;
+                arr[k + 1] = c[k].arr_time;
+            }
+            dep[num_stops - 1] = arr[num_stops - 1];
+            time_offset += num_stops;
+        }
+    }
+    data->route_trip_offset[num_routes] = key;
+
+    // Índice inverso: rotas (e posições) que passam por cada estação
+    data->station_route_offset = raptor_alloc(tt->num_stations + 1);
+    data->station_routes = raptor_alloc(2 * total_stops);
+    for (int s = 0; s <= tt->num_stations; s++) {
+        data->station_route_offset[s] = 0;
+    }
+    for (int i = 0; i < total_stops; i++) {
+        data->station_route_offset[data->route_stops[i] + 1]++;
+    }
+    for (int s = 0; s < tt->num_stations; s++) {
+        data->station_route_offset[s + 1] += data->station_route_offset[s];
+    }
+    int* fill = raptor_alloc(tt->num_stations);
+    for (int s = 0; s < tt->num_stations; s++) {
+        fill[s] = data->station_route_offset[s];
+    }
+    for (int r = 0; r < num_routes; r++) {
+        for (int p = data->route_stop_offset[r]; p < data->route_stop_offset[r + 1]; p++) {
+            int s = data->route_stops[p];
+            data->station_routes[2 * fill[s]] = r;
+            data->station_routes[2 * fill[s] + 1] = p - data->route_stop_offset[r];
+            fill[s]++;
+        }
+    }
+
+    free(fill);
+    free(route_hash);
+    free(route_first_conn);
+    free(route_length);
+    free(keys);
+    free(by_trip);
+    return data;
+}
+
+// Libera a memória das estruturas do RAPTOR
+void free_raptor_data(RaptorData* data) {
+    if (!data) return;
+    free(data->route_stop_offset);
+    free(data->route_stops);
+    free(data->route_trip_offset);
+    free(data->route_time_offset);
+    free(data->trip_ids);
+    free(data->arr_times);
+    free(data->dep_times);
+    free(data->station_route_offset);
+    free(data->station_routes);
+    free(data);
+}
+
+/**
+ * @brief Consulta RAPTOR: conjunto de Pareto de jornadas (chegada, transferências).
+ *
+ * A rodada k considera jornadas com exatamente k viagens; cada rodada varre uma
+ * única vez as rotas que passam por estações melhoradas na rodada anterior.
+ *
+ * @param data Rotas e viagens construídas por build_raptor_data().
+ * @param start_station Estação de partida.
+ * @param end_station Estação de destino.
+ * @param departure_time Horário a partir do qual o passageiro está na origem.
+ * @param max_transfers Número máximo de transferências (limitado por RAPTOR_MAX_ROUNDS - 1).
+ * @param journeys Array de saída com até RAPTOR_MAX_ROUNDS jornadas.
+ * @return Número de jornadas no conjunto de Pareto (1, sem trechos, se origem e destino coincidem).
+ */
+int raptor_query(const RaptorData* data, int start_station, int end_station, int departure_time,
+                 int max_transfers, RaptorJourney journeys[]) {
+    if (start_station == end_station) {
+        // Jornada trivial: já no destino, sem viagens nem transferências
+        journeys[0].arrival_time = departure_time;
+        journeys[0].num_transfers = 0;
+        journeys[0].num_legs = 0;
+        return 1;
+    }
+    int num_stations = data->num_stations;
+    int max_rounds = max_transfers + 1;
+    if (max_rounds > RAPTOR_MAX_ROUNDS) max_rounds = RAPTOR_MAX_ROUNDS;
+    if (max_rounds < 1) max_rounds = 1;
+
+    int labels = (max_rounds + 1) * num_stations;
+    int* tau = raptor_alloc(labels);          // Chegada por rodada e estação
+    int* label_route = raptor_alloc(labels);  // Rota usada para chegar (ou -1)
+    int* label_trip = raptor_alloc(labels);   // Viagem (índice global de viagem)
+    int* label_board = raptor_alloc(labels);  // Posição de embarque na rota
+    int* label_alight = raptor_alloc(labels); // Posição de desembarque na rota
+    int* best = raptor_alloc(num_stations);
+    bool* marked = (bool*)malloc(num_stations * sizeof(bool));
+    int* queue_pos = raptor_alloc(data->num_routes);
+    int* queue_routes = raptor_alloc(data->num_routes);
+    if (!marked) {
+        perror("Erro ao alocar estruturas do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < labels; i++) {
+        tau[i] = TIME_INFINITY;
+        label_route[i] = -1;
+    }
+    for (int s = 0; s < num_stations; s++) {
+        best[s] = TIME_INFINITY;
+        marked[s] = false;
+    }
+    for (int r = 0; r < data->num_routes; r++) {
+        queue_pos[r] = -1;
+    }
+    tau[start_station] = departure_time;
+    best[start_station] = departure_time;
+    marked[start_station] = true;
+
+    int num_journeys = 0;
+    for (int k = 1; k <= max_rounds; k++) {
+        int* prev = &tau[(k - 1) * num_stations];
+        int* cur = &tau[k * num_stations];
+        for (int s = 0; s < num_stations; s++) {
+            cur[s] = prev[s];
+        }
+
+        // Coleta as rotas que servem estações marcadas, a partir da parada mais cedo
+        int num_queued = 0;
+        for (int s = 0; s < num_stations; s++) {
+            if (!marked[s]) continue;
+            marked[s] = false;
+            for (int i = data->station_route_offset[s]; i < data->station_route_offset[s + 1]; i++) {
+                int r = data->station_routes[2 * i];
+                int pos = data->station_routes[2 * i + 1];
+                if (queue_pos[r] == -1) {
+                    queue_routes[num_queued++] = r;
+                    queue_pos[r] = pos;
+                } else if (pos < queue_pos[r]) {
+                    queue_pos[r] = pos;
+                }
+            }
+        }
+        if (num_queued == 0) break;
+
+        // Percorre cada rota uma única vez
+        for (int q = 0; q < num_queued; q++) {
+            int r = queue_routes[q];
+            const int* stops = &data->route_stops[data->route_stop_offset[r]];
+            int num_stops = data->route_stop_offset[r + 1] - data->route_stop_offset[r];
+            int first_trip = data->route_trip_offset[r];
+            int num_trips = data->route_trip_offset[r + 1] - first_trip;
+            const int* arr_base = &data->arr_times[data->route_time_offset[r]];
+            const int* dep_base = &data->dep_times[data->route_time_offset[r]];
+
+            int trip = -1; // Viagem atual (índice local na rota)
+            int board_pos = -1;
+            for (int pos = queue_pos[r]; pos < num_stops; pos++) {
+                int s = stops[pos];
+
+                // Desembarque: melhora a chegada se vencer a melhor conhecida e a do destino
+                if (trip != -1) {
+                    int arr = arr_base[trip * num_stops + pos];
+                    int bound = best[s] < best[end_station] ? best[s] : best[end_station];
+                    if (arr < bound) {
+                        int label = k * num_stations + s;
+                        cur[s] = arr;
+                        best[s] = arr;
+                        label_route[label] = r;
+                        label_trip[label] = first_trip + trip;
+                        label_board[label] = board_pos;
+                        label_alight[label] = pos;
+                        marked[s] = true;
+                    }
+                }
+
+                // Embarque: procura a viagem mais cedo que parte após a chegada anterior
+                if (prev[s] != TIME_INFINITY && (trip == -1 || prev[s] <= dep_base[trip * num_stops + pos])) {
+                    int lo = 0, hi = (trip == -1) ? num_trips : trip;
+                    while (lo < hi) {
+                        int mid = lo + (hi - lo) / 2;
+                        if (dep_base[mid * num_stops + pos] < prev[s]) {
+                            lo = mid + 1;
+                        } else {
+                            hi = mid;
+                        }
+                    }
+                    if (lo < num_trips && (trip == -1 || lo < trip)) {
+                        trip = lo;
+                        board_pos = pos;
+                    }
+                }
+            }
+            queue_pos[r] = -1;
+        }
+
+        // Nova solução de Pareto: chegada estritamente melhor com mais viagens
+        int label = k * num_stations + end_station;
+        if (label_route[label] != -1 &&
+            (num_journeys == 0 || cur[end_station] < journeys[num_journeys - 1].arrival_time)) {
+            RaptorJourney* journey = &journeys[num_journeys++];
+            journey->arrival_time = cur[end_station];
+            journey->num_transfers = k - 1;
+            journey->num_legs = 0;
+
+            // Reconstrói os trechos de trás para frente, descendo pelas rodadas
+            RaptorLeg legs[RAPTOR_MAX_ROUNDS];
+            int station = end_station;
+            int round = k;
+            while (station != start_station && round > 0) {
+                int l = round * num_stations + station;
+                while (round > 0 && label_route[l] == -1) {
+                    round--;
+                    l = round * num_stations + station;
+                }
+                if (round == 0) break;
+                int r = label_route[l];
+                int trip_index = label_trip[l];
+                int num_stops = data->route_stop_offset[r + 1] - data->route_stop_offset[r];
+                int local = trip_index - data->route_trip_offset[r];
+                const int* arr_base = &data->arr_times[data->route_time_offset[r]];
+                const int* dep_base = &data->dep_times[data->route_time_offset[r]];
+                RaptorLeg* leg = &legs[journey->num_legs++];
+                leg->trip_id = data->trip_ids[trip_index];
+                leg->from_station = data->route_stops[data->route_stop_offset[r] + label_board[l]];
+                leg->to_station = station;
+                leg->dep_time = dep_base[local * num_stops + label_board[l]];
+                leg->arr_time = arr_base[local * num_stops + label_alight[l]];
+                station = leg->from_station;
+                round--;
+            }
+            for (int i = 0; i < journey->num_legs; i++) {
+                journey->legs[i] = legs[journey->num_legs - 1 - i];
+            }
+        }
+    }
+
+    free(tau);
+    free(label_route);
+    free(label_trip);
+    free(label_board);
+    free(label_alight);
+    free(best);
+    free(marked);
+    free(queue_pos);
+    free(queue_routes);
+    return num_journeys;
+}
+
+// Imprime o conjunto de Pareto de jornadas encontrado pelo RAPTOR
+void print_raptor_journeys(const RaptorData* data, const RaptorJourney journeys[], int num_journeys) {
+    if (num_journeys == 0) {
+        printf("Nenhuma jornada encontrada.\n");
+        return;
+    }
+    for (int j = 0; j < num_journeys; j++) {
+        const RaptorJourney* journey = &journeys[j];
+        printf("Opção %d: chegada %02d:%02d, %d transferência(s)\n", j + 1,
+               journey->arrival_time / 60, journey->arrival_time % 60, journey->num_transfers);
+        if (journey->num_legs == 0) {
+            printf("  Nenhuma viagem necessária: a origem já é o destino.\n");
+        }
+        for (int i = 0; i < journey->num_legs; i++) {
+            const RaptorLeg* leg = &journey->legs[i];
+            printf("  Viagem %d: %s (%02d:%02d) -> %s (%02d:%02d)\n", leg->trip_id,
+                   data->node_names[leg->from_station], leg->dep_time / 60, leg->dep_time % 60,
+                   data->node_names[leg->to_station], leg->arr_time / 60, leg->arr_time % 60);
+        }
+    }
+}
+
+// --- Funções de Impressão e Interação ---
+
+/**
+ * @brief Escreve o caminho de start_node até end_node, em ordem direta, no buffer do chamador.
+ *
+ * Mede o caminho pela cadeia de pais e depois o preenche de trás para frente,
+ * sem array intermediário nem inversão. Como em snprintf, nada é escrito se o
+ * buffer for pequeno; o retorno informa o tamanho necessário.
+ *
+ * @param parent Array de predecessores da busca.
+ * @param start_node O nó de partida.
+ * @param end_node O nó de chegada.
+ * @param path Buffer de saída (pode ser NULL se capacity for 0).
+ * @param capacity Número de posições disponíveis em path.
+ * @return O número de estações do caminho, ou 0 se end_node não leva a start_node.
+ */
+int emit_path(const int parent[], int start_node, int end_node, int path[], int capacity) {
+    int path_len = 1;
+    for (int current = end_node; current != start_node; path_len++) {
+        current = parent[current];
+        if (current == -1) {
+            return 0;
+        }
+    }
+    if (path_len > capacity) {
+        return path_len;
+    }
+    int current = end_node;
+    for (int i = path_len - 1; i >= 0; i--) {
+        path[i] = current;
+        current = parent[current];
+    }
+    return path_len;
+}
+
+// Grava "-> A-> B..." montando o texto em um buffer e usando um único fwrite por bloco
+void write_path_names(FILE* file, const Graph* graph, const int path[], int path_len) {
+    char buffer[4096];
+    size_t length = 0;
+    for (int i = 0; i < path_len; i++) {
+        const char* name = graph->node_names[path[i]];
+        size_t name_len = strlen(name);
+        if (length + name_len + 3 > sizeof(buffer)) {
+            fwrite(buffer, 1, length, file);
+            length = 0;
+        }
+        if (name_len + 3 > sizeof(buffer)) { // Nome maior que o buffer: grava direto
+            fwrite("-> ", 1, 3, file);
+            fwrite(name, 1, name_len, file);
+            continue;
+        }
+        memcpy(&buffer[length], "-> ", 3);
+        memcpy(&buffer[length + 3], name, name_len);
+        length += name_len + 3;
+    }
+    fwrite(buffer, 1, length, file);
+    fputc('\n', file);
+}
+
+// Imprime o caminho encontrado do início ao fim
+void print_path(Graph* graph, int parent[], int start_node, int end_node) {
+    if (end_node == start_node) {
+        printf("Você já está em '%s'.\n", graph->node_names[start_node]);
+        return;
+    }
+    int path_len = emit_path(parent, start_node, end_node, NULL, 0);
+    if (path_len == 0) {
+        printf("Não há caminho disponível de '%s' para '%s'.\n",
+               graph->node_names[start_node], graph->node_names[end_node]);
+        return;
+    }
+
+    int* path = (int*)malloc(path_len * sizeof(int));
+    if (!path) {
+        perror("Erro ao alocar caminho");
+        exit(EXIT_FAILURE);
+    }
+    emit_path(parent, start_node, end_node, path, path_len);
+
+    printf("Melhor trajeto:\n");
+    fflush(stdout); // Mantém a ordem com a escrita em blocos abaixo
+    write_path_names(stdout, graph, path, path_len);
+    free(path);
+}
+
+/**
+ * @brief Lê uma estação digitada pelo usuário, por número ou por nome.
+ *
+ * Se o texto não corresponder exatamente a um nome, mostra as estações que
+ * começam com ele (autocompletar) e a seleção falha.
+ *
+ * @param graph O grafo de transporte.
+ * @param index O índice de nomes das estações.
+ * @return O índice da estação, ou -1 se a entrada for inválida.
+ */
+int read_station(Graph* graph, NameIndex* index) {
+    char line[128];
+    if (!fgets(line, sizeof(line), stdin)) {
+        return -1;
+    }
+    line[strcspn(line, "\r\n")] = '\0';
+
+    char* end;
+    long number = strtol(line, &end, 10);
+    if (end != line && *end == '\0') {
+        return (number >= 0 && number < graph->num_nodes) ? (int)number : -1;
+    }
+
+    int node = find_node_by_name(index, line);
+    if (node != -1) {
+        return node;
+    }
+
+    int matches[MAX_NODES];
+    int num_matches = line[0] ? autocomplete_station(index, line, matches, MAX_NODES) : 0;
+    if (num_matches > 0) {
+        printf("Você quis dizer:");
+        for (int i = 0; i < num_matches; i++) {
+            printf(" %d. %s%s", matches[i], graph->node_names[matches[i]], i + 1 < num_matches ? ";" : "\n");
+        }
+    }
+    return -1;
+}
+
+// --- Verificação de Consistência ---
+
+// Gerador congruencial simples e reprodutível para os testes aleatórios
+unsigned int verify_random(unsigned int* seed, unsigned int bound) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (*seed >> 8) % bound;
+}
+
+/**
+ * @brief Compara RAPTOR com CSA em quadros de horários aleatórios com ultrapassagens.
+ *
+ * Cada viagem tem tempos de percurso sorteados, de modo que viagens da mesma
+ * linha se ultrapassam com frequência. A melhor chegada do RAPTOR nunca pode
+ * ser anterior à do CSA e deve ser igual quando a jornada do CSA usa no máximo
+ * RAPTOR_MAX_ROUNDS viagens.
+ *
+ * @param seed Semente dos quadros sorteados.
+ * @param num_queries Número de consultas (origem, destino, horário).
+ * @return Número de consultas em que os dois algoritmos divergiram.
+ */
+int verify_raptor_against_csa(unsigned int seed, int num_queries) {
+    const int num_stations = MAX_NODES;
+    Graph* graph = create_graph(num_stations);
+    for (int i = 0; i < num_stations; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "E%d", i);
+        set_node_name(graph, i, name);
+    }
+
+    int mismatches = 0;
+    int done = 0;
+    int* arrival = (int*)malloc(num_stations * sizeof(int));
+    int* in_connection = (int*)malloc(num_stations * sizeof(int));
+    if (!arrival || !in_connection) {
+        perror("Erro ao alocar verificação do RAPTOR");
+        exit(EXIT_FAILURE);
+    }
+    while (done < num_queries) {
+        // Um quadro novo a cada 50 consultas: 6 linhas de 3 a 6 paradas distintas
+        Timetable* tt = create_timetable(graph);
+        for (int line = 0; line < 6; line++) {
+            int stops[6], times[5];
+            int num_stops = 3 + (int)verify_random(&seed, 4);
+            for (int i = 0; i < num_stops; i++) {
+                bool repeated;
+                do {
+                    stops[i] = (int)verify_random(&seed, num_stations);
+                    repeated = false;
+                    for (int j = 0; j < i; j++) repeated = repeated || stops[j] == stops[i];
+                } while (repeated);
+            }
+            for (int trip = 0; trip < 12; trip++) {
+                for (int i = 0; i + 1 < num_stops; i++) {
+                    times[i] = 2 + (int)verify_random(&seed, 30);
+                }
+                add_trip(tt, stops, times, num_stops, 6 * 60 + (int)verify_random(&seed, 240));
+            }
+        }
+        sort_timetable(tt);
+        RaptorData* raptor = build_raptor_data(tt);
+        int* boarded_at = (int*)malloc((tt->num_trips + 1) * sizeof(int));
+        if (!boarded_at) {
+            perror("Erro ao alocar verificação do RAPTOR");
+            exit(EXIT_FAILURE);
+        }
+
+        for (int q = 0; q < 50 && done < num_queries; q++, done++) {
+            int start = (int)verify_random(&seed, num_stations);
+            int end = (int)verify_random(&seed, num_stations);
+            int departure = 6 * 60 + (int)verify_random(&seed, 240);
+            int expected = csa_earliest_arrival(tt, start, end, departure, arrival, in_connection, boarded_at);
+            int csa_trips = 0;
+            for (int station = end; expected != TIME_INFINITY && station != start; csa_trips++) {
+                int board = boarded_at[tt->connections[in_connection[station]].trip_id];
+                station = tt->connections[board].dep_station;
+            }
+
+            RaptorJourney journeys[RAPTOR_MAX_ROUNDS];
+            int num_journeys = raptor_query(raptor, start, end, departure, RAPTOR_MAX_ROUNDS - 1, journeys);
+            int found = num_journeys > 0 ? journeys[num_journeys - 1].arrival_time : TIME_INFINITY;
+            if (found < expected || (found != expected && csa_trips <= RAPTOR_MAX_ROUNDS)) {
+                mismatches++;
+            }
+        }
+        free(boarded_at);
+        free_raptor_data(raptor);
+        free_timetable(tt);
+    }
+    free(arrival);
+    free(in_connection);
+    free_graph(graph);
+    return mismatches;
+}
+
+// Grafo aleatório com arestas de peso 1 a 60, para as verificações
+Graph* verify_random_graph(unsigned int* seed, int num_nodes, int num_edges) {
+    Graph* graph = create_graph(num_nodes);
+    for (int e = 0; e < num_edges; e++) {
+        int src = (int)verify_random(seed, num_nodes);
+        int dest = (int)verify_random(seed, num_nodes);
+        add_edge(graph, src, dest, (weight_t)(1 + verify_random(seed, 60)));
+    }
+    return graph;
+}
+
+// Troca o peso de uma aresta sorteada (1 a 60); retorna false se o nó sorteado não tiver arestas
+bool verify_change_random_edge(unsigned int* seed, Graph* graph, int* src, int* dest, weight_t* new_weight) {
+    *src = (int)verify_random(seed, graph->num_nodes);
+    if (!graph->adj_lists[*src]) {
+        return false;
+    }
+    int degree = 0;
+    for (AdjListNode* current = graph->adj_lists[*src]; current; current = current->next) {
+        degree++;
+    }
+    AdjListNode* edge = graph->adj_lists[*src];
+    for (int k = (int)verify_random(seed, degree); k > 0; k--) {
+        edge = edge->next;
+    }
+    *dest = edge->dest;
+    *new_weight = (weight_t)(1 + verify_random(seed, 60));
+    return true;
+}
+
+// Peso do caminho registrado em parent[] de start a end, usando a menor aresta paralela
+// de cada passo; INFINITY se algum passo não for uma aresta do grafo
+dist_t verify_parent_weight(const Graph* graph, const int parent[], int start, int end) {
+    dist_t total = 0;
+    for (int v = end; v != start; v = parent[v]) {
+        int u = parent[v];
+        if (u == -1) {
+            return INFINITY;
+        }
+        dist_t best = INFINITY;
+        for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+            if (current->dest == v && current->weight < best) {
+                best = current->weight;
+            }
+        }
+        if (best == INFINITY) {
+            return INFINITY;
+        }
+        total = dist_add(total, best);
+    }
+    return total;
+}
+
+/**
+ * @brief Compara alt_query() com dijkstra() em grafos aleatórios.
+ *
+ * As tabelas de landmarks só valem para os pesos com que foram calculadas, então
+ * cada grafo recebe tabelas novas. O caminho devolvido deve realizar a distância.
+ *
+ * @param seed Semente dos grafos e das consultas.
+ * @param num_graphs Número de grafos (100 consultas por grafo).
+ * @return Número de consultas com resposta incorreta.
+ */
+int verify_alt(unsigned int seed, int num_graphs) {
+    const int num_nodes = 300;
+    dist_t* expected = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    dist_t* dist = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!expected || !dist || !parent) {
+        perror("Erro ao alocar verificação do ALT");
+        exit(EXIT_FAILURE);
+    }
+    int mismatches = 0;
+    for (int g = 0; g < num_graphs; g++) {
+        Graph* graph = verify_random_graph(&seed, num_nodes, (2 + g % 4) * num_nodes);
+        LandmarkTable* landmarks = build_landmark_table(graph, 1 + g % 6);
+        for (int q = 0; q < 100; q++) {
+            int start = (int)verify_random(&seed, num_nodes);
+            int end = (int)verify_random(&seed, num_nodes);
+            dijkstra(graph, start, expected, parent);
+            dist_t found = alt_query(graph, landmarks, start, end, dist, parent, NULL);
+            if (found != expected[end] ||
+                (found != INFINITY && verify_parent_weight(graph, parent, start, end) != found)) {
+                mismatches++;
+            }
+        }
+        free_landmark_table(landmarks);
+        free_graph(graph);
+    }
+    free(expected);
+    free(dist);
+    free(parent);
+    return mismatches;
+}
+
+/**
+ * @brief Compara dijkstra_arc_flags() com dijkstra() enquanto os pesos mudam.
+ *
+ * A partição é feita uma vez por grafo; após cada rodada, alguns pesos mudam
+ * com update_edge_weight() e compute_arc_flags() recalcula os flags, que
+ * precisam continuar levando a caminhos mínimos.
+ *
+ * @param seed Semente dos grafos, das alterações e das consultas.
+ * @param num_rounds Número de rodadas por grafo (100 consultas por rodada).
+ * @return Número de consultas com resposta incorreta.
+ */
+int verify_arc_flags(unsigned int seed, int num_rounds) {
+    const int num_nodes = 300;
+    dist_t* expected = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    dist_t* dist = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!expected || !dist || !parent) {
+        perror("Erro ao alocar verificação dos arc-flags");
+        exit(EXIT_FAILURE);
+    }
+    const int region_counts[4] = {2, 4, 16, MAX_REGIONS};
+    int mismatches = 0;
+    for (int g = 0; g < 4; g++) {
+        Graph* graph = verify_random_graph(&seed, num_nodes, 4 * num_nodes);
+        ArcFlags* flags = build_arc_flags(graph, region_counts[g]);
+        for (int round = 0; round < num_rounds; round++) {
+            for (int q = 0; q < 100; q++) {
+                int start = (int)verify_random(&seed, num_nodes);
+                int end = (int)verify_random(&seed, num_nodes);
+                dijkstra(graph, start, expected, parent);
+                dist_t found = dijkstra_arc_flags(flags, start, end, dist, parent, NULL);
+                if (found != expected[end] ||
+                    (found != INFINITY && verify_parent_weight(graph, parent, start, end) != found)) {
+                    mismatches++;
+                }
+            }
+            for (int k = 0; k < 5; k++) {
+                int src, dest;
+                weight_t new_weight;
+                if (verify_change_random_edge(&seed, graph, &src, &dest, &new_weight)) {
+                    update_edge_weight(graph, src, dest, new_weight, NULL);
+                }
+            }
+            compute_arc_flags(flags, graph);
+        }
+        free_arc_flags(flags);
+        free_graph(graph);
+    }
+    free(expected);
+    free(dist);
+    free(parent);
+    return mismatches;
+}
+
+/**
+ * @brief Compara hub_label_distance() com dijkstra() para todos os pares.
+ *
+ * @param seed Semente dos grafos.
+ * @param num_graphs Número de grafos aleatórios (200 nós, densidade variada).
+ * @return Número de pares com distância incorreta.
+ */
+int verify_hub_labels(unsigned int seed, int num_graphs) {
+    const int num_nodes = 200;
+    dist_t* expected = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!expected || !parent) {
+        perror("Erro ao alocar verificação dos rótulos de hubs");
+        exit(EXIT_FAILURE);
+    }
+    int mismatches = 0;
+    for (int g = 0; g < num_graphs; g++) {
+        Graph* graph = verify_random_graph(&seed, num_nodes, (1 + g % 4) * num_nodes);
+        HubLabels* labels = build_hub_labels(graph);
+        for (int s = 0; s < num_nodes; s++) {
+            dijkstra(graph, s, expected, parent);
+            for (int t = 0; t < num_nodes; t++) {
+                if (hub_label_distance(labels, s, t) != expected[t]) {
+                    mismatches++;
+                }
+            }
+        }
+        free_hub_labels(labels);
+        free_graph(graph);
+    }
+    free(expected);
+    free(parent);
+    return mismatches;
+}
+
+/**
+ * @brief Compara hub_label_table() com dijkstra_table() em tabelas aleatórias.
+ *
+ * Origens e destinos são sorteados com repetição; a própria dijkstra_table()
+ * é conferida contra dijkstra() completo antes de servir de referência.
+ *
+ * @param seed Semente dos grafos e das tabelas.
+ * @param num_graphs Número de grafos aleatórios (300 nós).
+ * @param num_mismatches Saída: células de hub_label_table() diferentes da referência.
+ * @return Número de células de dijkstra_table() diferentes de dijkstra().
+ */
+int verify_distance_tables(unsigned int seed, int num_graphs, int* num_mismatches) {
+    const int num_nodes = 300;
+    const int max_side = 40;
+    int* sources = (int*)malloc(max_side * sizeof(int));
+    int* targets = (int*)malloc(max_side * sizeof(int));
+    dist_t* reference = (dist_t*)malloc(max_side * max_side * sizeof(dist_t));
+    dist_t* table = (dist_t*)malloc(max_side * max_side * sizeof(dist_t));
+    dist_t* expected = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!sources || !targets || !reference || !table || !expected || !parent) {
+        perror("Erro ao alocar verificação das tabelas de distâncias");
+        exit(EXIT_FAILURE);
+    }
+    int reference_errors = 0;
+    *num_mismatches = 0;
+    for (int g = 0; g < num_graphs; g++) {
+        Graph* graph = verify_random_graph(&seed, num_nodes, (2 + g % 3) * num_nodes);
+        HubLabels* labels = build_hub_labels(graph);
+        for (int round = 0; round < 5; round++) {
+            int num_sources = 1 + (int)verify_random(&seed, max_side);
+            int num_targets = 1 + (int)verify_random(&seed, max_side);
+            for (int i = 0; i < num_sources; i++) {
+                sources[i] = (int)verify_random(&seed, num_nodes);
+            }
+            for (int j = 0; j < num_targets; j++) {
+                // Metade dos destinos repete um anterior
+                targets[j] = (j > 0 && verify_random(&seed, 2) == 0)
+                                 ? targets[verify_random(&seed, j)]
+                                 : (int)verify_random(&seed, num_nodes);
+            }
+            dijkstra_table(graph, sources, num_sources, targets, num_targets, reference);
+            hub_label_table(labels, sources, num_sources, targets, num_targets, table);
+            for (int i = 0; i < num_sources; i++) {
+                dijkstra(graph, sources[i], expected, parent);
+                for (int j = 0; j < num_targets; j++) {
+                    int cell = i * num_targets + j;
+                    if (reference[cell] != expected[targets[j]]) {
+                        reference_errors++;
+                    }
+                    if (table[cell] != reference[cell]) {
+                        (*num_mismatches)++;
+                    }
+                }
+            }
+        }
+        free_hub_labels(labels);
+        free_graph(graph);
+    }
+    free(sources);
+    free(targets);
+    free(reference);
+    free(table);
+    free(expected);
+    free(parent);
+    return reference_errors;
+}
+
+/**
+ * @brief Compara crp_query() com dijkstra() enquanto os pesos mudam.
+ *
+ * Overlays de 1, 2 e 3 níveis (8, 16 e 64 células no nível 1); após cada rodada,
+ * alguns pesos mudam com update_edge_weight() e crp_customize() recalcula as
+ * cliques sem refazer a partição.
+ *
+ * @param seed Semente dos grafos, das alterações e das consultas.
+ * @param num_rounds Número de rodadas por overlay (100 consultas por rodada).
+ * @return Número de consultas com resposta incorreta.
+ */
+int verify_crp(unsigned int seed, int num_rounds) {
+    const int num_nodes = 300;
+    dist_t* expected = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!expected || !parent) {
+        perror("Erro ao alocar verificação do CRP");
+        exit(EXIT_FAILURE);
+    }
+    const int level_counts[3] = {1, 2, 3};
+    const int cell_counts[3] = {8, 16, 64};
+    int mismatches = 0;
+    for (int g = 0; g < 3; g++) {
+        Graph* graph = verify_random_graph(&seed, num_nodes, 4 * num_nodes);
+        CrpOverlay* overlay = build_crp_overlay(graph, level_counts[g], cell_counts[g]);
+        for (int round = 0; round < num_rounds; round++) {
+            for (int q = 0; q < 100; q++) {
+                int start = (int)verify_random(&seed, num_nodes);
+                int end = (int)verify_random(&seed, num_nodes);
+                dijkstra(graph, start, expected, parent);
+                if (crp_query(overlay, start, end, NULL) != expected[end]) {
+                    mismatches++;
+                }
+            }
+            for (int k = 0; k < 5; k++) {
+                int src, dest;
+                weight_t new_weight;
+                if (verify_change_random_edge(&seed, graph, &src, &dest, &new_weight)) {
+                    update_edge_weight(graph, src, dest, new_weight, NULL);
+                }
+            }
+            crp_customize(overlay, graph);
+        }
+        free_crp_overlay(overlay);
+        free_graph(graph);
+    }
+    free(expected);
+    free(parent);
+    return mismatches;
+}
+
+/**
+ * @brief Compara as respostas do cache de rotas com dijkstra() enquanto o grafo muda.
+ *
+ * Poucos pares e um cache pequeno forçam acertos, falhas e substituições; o
+ * peso de uma aresta muda a cada rodada, o que deve invalidar todo o cache.
+ * Cada caminho devolvido precisa ligar origem a destino com a distância exata.
+ *
+ * @param seed Semente do grafo e das consultas.
+ * @param num_rounds Número de rodadas (uma alteração de peso entre rodadas).
+ * @return Número de consultas com resposta incorreta.
+ */
+int verify_route_cache(unsigned int seed, int num_rounds) {
+    const int num_nodes = 300, num_origins = 12, num_destinations = 16, queries_per_round = 1000;
+    Graph* graph = verify_random_graph(&seed, num_nodes, 4 * num_nodes);
+    RouteCache* cache = create_route_cache(graph, 128, 4, 16);
+    int origins[12], destinations[16];
+    for (int i = 0; i < num_origins; i++) {
+        origins[i] = (int)verify_random(&seed, num_nodes);
+    }
+    for (int i = 0; i < num_destinations; i++) {
+        destinations[i] = (int)verify_random(&seed, num_nodes);
+    }
+    dist_t* reference = (dist_t*)malloc((size_t)num_origins * num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    int* path = (int*)malloc(num_nodes * sizeof(int));
+    if (!reference || !parent || !path) {
+        perror("Erro ao alocar verificação do cache");
+        exit(EXIT_FAILURE);
+    }
+
+    int mismatches = 0;
+    for (int round = 0; round < num_rounds; round++) {
+        for (int i = 0; i < num_origins; i++) {
+            dijkstra(graph, origins[i], &reference[(size_t)i * num_nodes], parent);
+        }
+        for (int q = 0; q < queries_per_round; q++) {
+            int which = (int)verify_random(&seed, num_origins);
+            int origin = origins[which];
+            int destination = destinations[verify_random(&seed, num_destinations)];
+            dist_t expected = reference[(size_t)which * num_nodes + destination];
+            if (q % 4 == 3) { // Só a distância
+                if (route_cache_query(cache, graph, origin, destination, NULL, NULL) != expected) {
+                    mismatches++;
+                }
+                continue;
+            }
+            int path_len;
+            dist_t distance = route_cache_query(cache, graph, origin, destination, path, &path_len);
+            if (distance != expected || (expected == INFINITY) != (path_len == 0)) {
+                mismatches++;
+                continue;
+            }
+            if (path_len == 0) continue;
+
+            // O caminho deve seguir arestas existentes e somar a distância
+            bool valid = path[0] == origin && path[path_len - 1] == destination;
+            dist_t total = 0;
+            for (int i = 0; valid && i + 1 < path_len; i++) {
+                dist_t best = INFINITY;
+                for (AdjListNode* current = graph->adj_lists[path[i]]; current; current = current->next) {
+                    if (current->dest == path[i + 1] && current->weight < best) {
+                        best = current->weight;
+                    }
+                }
+                valid = best != INFINITY;
+                total = dist_add(total, best);
+            }
+            if (!valid || total != expected) {
+                mismatches++;
+            }
+        }
+
+        int src, dest;
+        weight_t new_weight;
+        if (verify_change_random_edge(&seed, graph, &src, &dest, &new_weight)) {
+            update_edge_weight(graph, src, dest, new_weight, NULL);
+        }
+    }
+    print_route_cache_stats(cache);
+
+    free(reference);
+    free(parent);
+    free(path);
+    free_route_cache(cache);
+    free_graph(graph);
+    return mismatches;
+}
+
+/**
+ * @brief Compara a árvore incremental com um dijkstra() completo após cada alteração.
+ *
+ * Os pesos sorteados produzem reduções e aumentos, dentro e fora da árvore.
+ * Além das distâncias, cada predecessor deve ser o início de uma aresta que
+ * realiza a distância do nó.
+ *
+ * @param seed Semente do grafo e das alterações.
+ * @param num_updates Número de alterações de peso.
+ * @return Número de alterações após as quais a árvore divergiu.
+ */
+int verify_incremental_tree(unsigned int seed, int num_updates) {
+    const int num_nodes = 300;
+    Graph* graph = verify_random_graph(&seed, num_nodes, 4 * num_nodes);
+    // Origem com arestas de saída, para que a árvore não se reduza a um nó
+    int source;
+    do {
+        source = (int)verify_random(&seed, num_nodes);
+    } while (!graph->adj_lists[source]);
+    ShortestPathTree* tree = create_shortest_path_tree(graph, source);
+    dist_t* dist = (dist_t*)malloc(num_nodes * sizeof(dist_t));
+    int* parent = (int*)malloc(num_nodes * sizeof(int));
+    if (!dist || !parent) {
+        perror("Erro ao alocar verificação da árvore");
+        exit(EXIT_FAILURE);
+    }
+
+    int mismatches = 0;
+    long settled = 0;
+    for (int update = 0; update < num_updates; update++) {
+        int src, dest;
+        weight_t new_weight;
+        if (!verify_change_random_edge(&seed, graph, &src, &dest, &new_weight)) continue;
+        settled += update_tree_edge_weight(tree, graph, src, dest, new_weight);
+
+        dijkstra(graph, tree->source, dist, parent);
+        bool valid = true;
+        for (int v = 0; v < num_nodes && valid; v++) {
+            valid = tree->dist[v] == dist[v];
+            int u = tree->parent[v];
+            if (valid && u != -1) {
+                dist_t best = INFINITY;
+                for (AdjListNode* current = graph->adj_lists[u]; current; current = current->next) {
+                    if (current->dest == v && current->weight < best) {
+                        best = current->weight;
+                    }
+                }
+                valid = best != INFINITY && dist_add(tree->dist[u], best) == tree->dist[v];
+            }
+        }
+        if (!valid) {
+            mismatches++;
+        }
+    }
+    printf("Árvore incremental: %.1f nó(s) reprocessado(s) por alteração, de %d.\n",
+           (double)settled / num_updates, num_nodes);
+
+    free(dist);
+    free(parent);
+    free_shortest_path_tree(tree);
+    free_graph(graph);
+    return mismatches;
+}
+
+// Confere dijkstra_auto() contra dijkstra() abaixo e acima do ponto de troca medido
+int verify_dijkstra_auto(unsigned int seed) {
+    int mismatches = 0;
+    dist_t* expected = NULL;
+    dist_t* dist = NULL;
+    int* parent = NULL;
+    for (int n = 8; n <= 4096; n *= 2) {
+        expected = (dist_t*)realloc(expected, n * sizeof(dist_t));
+        dist = (dist_t*)realloc(dist, n * sizeof(dist_t));
+        parent = (int*)realloc(parent, n * sizeof(int));
+        if (!expected || !dist || !parent) {
+            perror("Erro ao alocar verificação do Dijkstra");
+            exit(EXIT_FAILURE);
+        }
+        Graph* graph = verify_random_graph(&seed, n, 4 * n);
+        int source = (int)verify_random(&seed, n);
+        dijkstra(graph, source, expected, parent);
+        dijkstra_auto(graph, source, dist, parent);
+        for (int v = 0; v < n; v++) {
+            if (dist[v] != expected[v]) {
+                mismatches++;
+                break;
+            }
+        }
+        free_graph(graph);
+    }
+    free(expected);
+    free(dist);
+    free(parent);
+    return mismatches;
+}
+
+// Modo "verificar": ./projeto2 verificar [semente]
+// Confronta as estruturas aceleradas com os algoritmos de referência em dados aleatórios.
+int verification_command(int argc, char* argv[]) {
+    unsigned int seed = argc >= 3 ? (unsigned int)strtoul(argv[2], NULL, 10) : 1u;
+    int failures = 0;
+
+    int raptor_mismatches = verify_raptor_against_csa(seed, 20000);
+    printf("RAPTOR x CSA: %d divergência(s) em %d consultas.\n", raptor_mismatches, 20000);
+    failures += raptor_mismatches;
+
+    int cache_mismatches = verify_route_cache(seed, 40);
+    printf("Cache de rotas x Dijkstra: %d divergência(s) em %d consultas.\n", cache_mismatches, 40 * 1000);
+    failures += cache_mismatches;
+
+    int tree_mismatches = verify_incremental_tree(seed, 5000);
+    printf("Árvore incremental x Dijkstra: %d divergência(s) em %d alterações.\n", tree_mismatches, 5000);
+    failures += tree_mismatches;
+
+    int auto_mismatches = verify_dijkstra_auto(seed);
+    printf("Dijkstra automático (heap a partir de %d nós) x Dijkstra: %d divergência(s) em 10 grafos.\n",
+           dijkstra_crossover, auto_mismatches);
+    failures += auto_mismatches;
+
+    int alt_mismatches = verify_alt(seed, 20);
+    printf("ALT x Dijkstra: %d divergência(s) em %d consultas.\n", alt_mismatches, 20 * 100);
+    failures += alt_mismatches;
+
+    int flags_mismatches = verify_arc_flags(seed, 5);
+    printf("Arc-flags x Dijkstra: %d divergência(s) em %d consultas.\n", flags_mismatches, 4 * 5 * 100);
+    failures += flags_mismatches;
+
+    int crp_mismatches = verify_crp(seed, 5);
+    printf("CRP x Dijkstra: %d divergência(s) em %d consultas.\n", crp_mismatches, 3 * 5 * 100);
+    failures += crp_mismatches;
+
+    int hub_mismatches = verify_hub_labels(seed, 4);
+    printf("Rótulos de hubs x Dijkstra: %d divergência(s) em %d pares.\n", hub_mismatches, 4 * 200 * 200);
+    failures += hub_mismatches;
+
+    int table_mismatches;
+    int table_reference_errors = verify_distance_tables(seed, 6, &table_mismatches);
+    printf("Tabela por rótulos x dijkstra_table: %d divergência(s); dijkstra_table x Dijkstra: %d.\n",
+           table_mismatches, table_reference_errors);
+    failures += table_mismatches + table_reference_errors;
+
+    printf(failures == 0 ? "Verificação concluída sem falhas.\n" : "Verificação encontrou falhas.\n");
+    return failures == 0 ? 0 : 1;
+}
+
+// --- Função Principal ---
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "verificar") == 0) {
+        return verification_command(argc, argv);
+    }
+
+    // Nomes das estações/paradas
+    const char* station_names[] = {
+        "Centro", "Rodoviaria", "Shopping", "Parque", "Hospital",
+        "Aeroporto", "Praia", "Bairro Norte", "Bairro Sul", "Terminal Central"
+    };
+    int num_stations = 10; // Usando apenas as 10 primeiras para este exemplo
+
+    Graph* graph = create_graph(num_stations);
+
+    // Atribui os nomes aos nós do grafo
+    for (int i = 0; i < num_stations; i++) {
+        set_node_name(graph, i, station_names[i]);
+    }
+
+    // Define as arestas (conexões e tempos de deslocamento)
+    // Formato: add_edge(grafo, origem_idx, destino_idx, tempo_em_minutos);
+    add_edge(graph, 0, 1, 10); // Centro -> Rodoviaria (10 min)
+    add_edge(graph, 0, 2, 15); // Centro -> Shopping (15 min)
+    add_edge(graph, 1, 0, 12); // Rodoviaria -> Centro (12 min - pode ser diferente!)
+    add_edge(graph, 1, 3, 20); // Rodoviaria -> Parque (20 min)
+    add_edge(graph, 2, 4, 8);  // Shopping -> Hospital (8 min)
+    add_edge(graph, 3, 5, 25); // Parque -> Aeroporto (25 min)
+    add_edge(graph, 4, 1, 7);  // Hospital -> Rodoviaria (7 min)
+    add_edge(graph, 4, 6, 18); // Hospital -> Praia (18 min)
+    add_edge(graph, 5, 9, 30); // Aeroporto -> Terminal Central (30 min)
+    add_edge(graph, 6, 9, 22); // Praia -> Terminal Central (22 min)
+    add_edge(graph, 7, 0, 5);  // Bairro Norte -> Centro (5 min)
+    add_edge(graph, 8, 0, 8);  // Bairro Sul -> Centro (8 min)
+    add_edge(graph, 9, 5, 28); // Terminal Central -> Aeroporto (28 min)
+    add_edge(graph, 9, 6, 20); // Terminal Central -> Praia (20 min)
+    add_edge(graph, 3, 8, 10); // Parque -> Bairro Sul (10 min)
+
+
+    // Quadro de horários: carregado do arquivo informado na linha de comando ou,
+    // na ausência dele, gerado a partir das linhas de exemplo abaixo.
+    Timetable* timetable = create_timetable(graph);
+    if (argc > 1) {
+        if (load_timetable(timetable, argv[1]) < 0) {
+            free_timetable(timetable);
+            free_graph(graph);
+            return 1;
+        }
+    } else {
+        // Formato: estações da linha, tempos entre paradas e intervalo entre viagens
+        const int line_a_stops[] = {7, 0, 1, 3, 5}; // Bairro Norte -> Aeroporto
+        const int line_a_times[] = {5, 10, 20, 25};
+        const int line_b_stops[] = {8, 0, 2, 4, 6, 9}; // Bairro Sul -> Terminal Central
+        const int line_b_times[] = {8, 15, 8, 18, 22};
+        const int line_c_stops[] = {9, 5}; // Terminal Central -> Aeroporto
+        const int line_c_times[] = {28};
+        const int line_d_stops[] = {4, 1, 0}; // Hospital -> Centro
+        const int line_d_times[] = {7, 12};
+
+        for (int departure = 6 * 60; departure <= 22 * 60; departure += 20) {
+            add_trip(timetable, line_a_stops, line_a_times, 5, departure);
+            add_trip(timetable, line_b_stops, line_b_times, 6, departure + 5);
+            add_trip(timetable, line_d_stops, line_d_times, 3, departure + 10);
+        }
+        for (int departure = 6 * 60; departure <= 22 * 60; departure += 30) {
+            add_trip(timetable, line_c_stops, line_c_times, 2, departure);
+        }
+        sort_timetable(timetable);
+    }
+
+    printf("Bem-vindo ao Sistema de Rotas de Transporte Público!\n");
+    printf("Estações disponíveis:\n");
+    for (int i = 0; i < num_stations; i++) {
+        printf("%2d. %s\n", i, graph->node_names[i]);
+    }
+
+    NameIndex* name_index = build_name_index(graph);
+
+    // Entrada interativa do usuário
+    printf("\nSelecione o ponto de partida (digite o número ou o nome): ");
+    int start_index = read_station(graph, name_index);
+    if (start_index < 0 || start_index >= num_stations) {
+        printf("Estação de partida inválida.\n");
+        free_name_index(name_index);
+        free_timetable(timetable);
+        free_graph(graph);
+        return 1;
+    }
+
+    printf("Selecione o ponto de destino (digite o número ou o nome): ");
+    int end_index = read_station(graph, name_index);
+    if (end_index < 0 || end_index >= num_stations) {
+        printf("Estação de destino inválida.\n");
+        free_name_index(name_index);
+        free_timetable(timetable);
+        free_graph(graph);
+        return 1;
+    }
+    free_name_index(name_index);
+
+    printf("\nCalculando rota de '%s' para '%s'...\n",
+           graph->node_names[start_index], graph->node_names[end_index]);
+
+    dist_t dist[MAX_NODES]; // Distância mínima do início para cada nó
+    int parent[MAX_NODES];  // Predecessor no caminho mais curto
+    char text[32];          // Distância formatada para impressão
+
+    dijkstra(graph, start_index, dist, parent);
+
+    printf("\n--- Resultado do Trajeto ---\n");
+    printf("Tempo mínimo de viagem de '%s' para '%s': %s minutos.\n",
+           graph->node_names[start_index], graph->node_names[end_index],
+           format_distance(dist[end_index], text, sizeof(text))); // -1 se não houver caminho
+
+    if (dist[end_index] != INFINITY) {
+        print_path(graph, parent, start_index, end_index);
+    }
+
+    // Mesma consulta com A* guiado por landmarks (ALT)
+    LandmarkTable* landmarks = build_landmark_table(graph, 3);
+    int alt_settled = 0;
+    dist_t alt_dist = alt_query(graph, landmarks, start_index, end_index, dist, parent, &alt_settled);
+    printf("A* com landmarks (ALT): %s minutos, %d estação(ões) processada(s).\n",
+           format_distance(alt_dist, text, sizeof(text)), alt_settled);
+    free_landmark_table(landmarks);
+
+    // Mesma consulta com poda por arc-flags (4 regiões)
+    ArcFlags* arc_flags = build_arc_flags(graph, 4);
+    int flags_settled = 0;
+    dist_t flags_dist = dijkstra_arc_flags(arc_flags, start_index, end_index, dist, parent, &flags_settled);
+    printf("Dijkstra com arc-flags: %s minutos, %d estação(ões) processada(s).\n",
+           format_distance(flags_dist, text, sizeof(text)), flags_settled);
+    free_arc_flags(arc_flags);
+
+    // Mesma consulta sobre o overlay (CRP). Com poucas estações basta um nível de
+    // 4 células: um segundo nível agruparia CRP_FANOUT = 4 delas numa célula só
+    CrpOverlay* overlay = build_crp_overlay(graph, 1, 4);
+    int crp_settled = 0;
+    dist_t crp_dist = crp_query(overlay, start_index, end_index, &crp_settled);
+    printf("Overlay multinível (CRP): %s minutos, %d estação(ões) processada(s).\n",
+           format_distance(crp_dist, text, sizeof(text)), crp_settled);
+    free_crp_overlay(overlay);
+
+    // Mesma consulta pela interseção de rótulos de hubs (somente a distância)
+    HubLabels* hub_labels = build_hub_labels(graph);
+    dist_t hub_dist = hub_label_distance(hub_labels, start_index, end_index);
+    printf("Rótulos de hubs: %s minutos.\n", format_distance(hub_dist, text, sizeof(text)));
+
+    // Tabela de tempos da partida e do destino para todas as estações (buckets de hubs)
+    int table_sources[2] = {start_index, end_index};
+    int table_targets[MAX_NODES];
+    dist_t table[2 * MAX_NODES];
+    for (int i = 0; i < num_stations; i++) {
+        table_targets[i] = i;
+    }
+    hub_label_table(hub_labels, table_sources, 2, table_targets, num_stations, table);
+    printf("\n--- Tabela de Tempos (minutos) ---\n");
+    print_distance_table(graph, table_sources, 2, table_targets, num_stations, table);
+    free_hub_labels(hub_labels);
+
+    // Consulta por horário: chegada mais cedo usando o quadro de horários (CSA)
+    // Lido por linha: Enter sozinho (ou texto inválido) seleciona o padrão
+    int dep_hour = 8, dep_minute = 0;
+    char time_line[32];
+    printf("\nHorário de partida (HH:MM, padrão 08:00): ");
+    if (!fgets(time_line, sizeof(time_line), stdin) ||
+        sscanf(time_line, "%d:%d", &dep_hour, &dep_minute) != 2 ||
+        dep_hour < 0 || dep_hour > 23 || dep_minute < 0 || dep_minute > 59) {
+        dep_hour = 8;
+        dep_minute = 0;
+    }
+
+    int* arrival = (int*)malloc(num_stations * sizeof(int));
+    int* in_connection = (int*)malloc(num_stations * sizeof(int));
+    int* boarded_at = (int*)malloc((timetable->num_trips + 1) * sizeof(int));
+    if (!arrival || !in_connection || !boarded_at) {
+        perror("Erro ao alocar estruturas do CSA");
+        exit(EXIT_FAILURE);
+    }
+
+    int arrival_time = csa_earliest_arrival(timetable, start_index, end_index, dep_hour * 60 + dep_minute,
+                                            arrival, in_connection, boarded_at);
+
+    printf("\n--- Consulta por Horário (CSA) ---\n");
+    if (arrival_time == TIME_INFINITY) {
+        printf("Partindo às %02d:%02d, não há chegada possível a '%s' hoje.\n",
+               dep_hour, dep_minute, graph->node_names[end_index]);
+    } else {
+        printf("Partindo às %02d:%02d, chegada mais cedo a '%s': %02d:%02d.\n",
+               dep_hour, dep_minute, graph->node_names[end_index], arrival_time / 60, arrival_time % 60);
+        print_csa_journey(timetable, in_connection, boarded_at, start_index, end_index);
+    }
+
+    // Alternativas considerando o número de transferências (RAPTOR)
+    RaptorData* raptor = build_raptor_data(timetable);
+    RaptorJourney journeys[RAPTOR_MAX_ROUNDS];
+    int num_journeys = raptor_query(raptor, start_index, end_index, dep_hour * 60 + dep_minute,
+                                    RAPTOR_MAX_ROUNDS - 1, journeys);
+
+    printf("\n--- Alternativas por Transferências (RAPTOR) ---\n");
+    print_raptor_journeys(raptor, journeys, num_journeys);
+
+    free_raptor_data(raptor);
+    free(arrival);
+    free(in_connection);
+    free(boarded_at);
+    free_timetable(timetable);
 
-    // Liberar memria alocada para o grafo
+    // Liberar memória alocada para o grafo
     free_graph(graph);
 
     return 0;